@@ -0,0 +1,363 @@
+/*
+  c8bench - emulation speed over a corpus of ROMs
+
+  Runs every ROM headless on every engine for a fixed number of emulated
+  frames and prints one JSON line per ROM and engine: instructions per
+  second (MIPS), ns per instruction and frames per second, from the median
+  of the timed trials, plus the fastest and slowest trial and the peak
+  resident set size of the process so far. Warmup trials run first and
+  aren't counted; all trials continue from the same snapshot, so engine
+  caches stay warm and every trial executes the same instructions.
+
+  Without ROM files the corpus is resources/pong plus the synthetic ROMs
+  below, each stressing one kind of instruction. With --baseline, a
+  previous run's output, the change in MIPS per ROM and engine is
+  reported on stderr.
+
+  Usage: c8bench [--frames=<n>] [--ipf=<n>] [--trials=<n>] [--warmup=<n>]
+                 [--engine=all|dispatch|threaded|block|jit] [--baseline=<file>] [<ROM file> ...]
+*/
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+#include "processor/chip8.hpp"
+
+struct Rom
+{
+  std::string name;
+  std::string path;             // empty for synthetic ROMs
+  std::vector<uint8_t> program;
+};
+
+struct Measurement
+{
+  uint64_t instructions;        // per trial
+  uint64_t idle;                // per trial
+  bool     halted;
+  double   median;              // seconds per trial
+  double   fastest;
+  double   slowest;
+  long     peakKilobytes;
+};
+
+/*
+  Loops that never wait, so nothing is skipped as idle and every
+  instruction is executed
+*/
+static const uint8_t alu[] = {
+  0x60, 0x01,   // V0 = 1
+  0x61, 0x03,   // V1 = 3
+  0x80, 0x14,   // V0 += V1
+  0x81, 0x05,   // V1 -= V0
+  0x80, 0x12,   // V0 &= V1
+  0x81, 0x13,   // V1 ^= V0
+  0x80, 0x16,   // V0 >>= 1
+  0x81, 0x0E,   // V1 <<= 1
+  0x80, 0x17,   // V0 = V1 - V0
+  0x70, 0x05,   // V0 += 5
+  0x80, 0x11,   // V0 |= V1
+  0x12, 0x04    // again
+};
+
+static const uint8_t draw[] = {
+  0x60, 0x00,   // V0 = 0, column
+  0x61, 0x00,   // V1 = 0, row
+  0x62, 0x00,   // V2 = 0, digit
+  0x63, 0x0F,
+  0xF2, 0x29,   // I = digit V2
+  0xD0, 0x15,   // draw it, wrapping around the edges
+  0x70, 0x07,
+  0x71, 0x03,
+  0x72, 0x01,
+  0x82, 0x32,   // V2 &= 0xF
+  0x12, 0x08    // again
+};
+
+static const uint8_t call[] = {
+  0x22, 0x04,   // call 0x204
+  0x12, 0x00,   // again
+  0x22, 0x0A,   // 0x204: call 0x20A
+  0x70, 0x01,
+  0x00, 0xEE,
+  0x22, 0x10,   // 0x20A: call 0x210
+  0x71, 0x01,
+  0x00, 0xEE,
+  0x72, 0x01,   // 0x210
+  0x00, 0xEE
+};
+
+static const uint8_t fx[] = {
+  0xA3, 0x00,   // I = 0x300
+  0x6A, 0x7B,   // VA = 123
+  0xFA, 0x33,   // BCD of VA at I
+  0xF2, 0x65,   // V0 - V2 = the digits
+  0xF0, 0x1E,   // I += V0
+  0xFA, 0x15,   // DT = VA
+  0xF4, 0x07,   // V4 = DT
+  0xFA, 0x18,   // ST = VA
+  0xF0, 0x29,   // I = digit V0
+  0x12, 0x00    // again
+};
+
+static Rom
+synthetic(const char *name, const uint8_t *program, size_t length)
+{
+  Rom rom;
+  rom.name = std::string("synthetic/") + name;
+  rom.program.assign(program, program + length);
+  return rom;
+}
+
+// peak resident set size of the whole process, in kilobytes on Linux
+static long
+peakKilobytes()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static const char *
+engineName(Processor::Engine engine)
+{
+  switch (engine)
+  {
+    case Processor::ENGINE_THREADED: return "threaded";
+    case Processor::ENGINE_BLOCK:    return "block";
+    case Processor::ENGINE_JIT:      return "jit";
+    default:                         return "dispatch";
+  }
+}
+
+/*
+  One trial: `frames` frames of `ipf` instructions, the way c8 runs them
+*/
+static double
+trial(Processor::Chip8 &c8, const Processor::Chip8State &start, uint32_t frames, uint32_t ipf)
+{
+  c8.load(start);
+
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  for (uint32_t frame = 0; frame < frames && !c8.halted; ++frame)
+  {
+    uint32_t done = 0;
+    while (done < ipf && !c8.halted)
+    {
+      done += c8.run(ipf - done);
+      c8.drawFlag = false;
+    }
+    c8.beepFlag = false;
+    c8.dirtyRows = 0;
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+static Measurement
+measure(const Rom &rom, Processor::Engine engine, uint32_t frames, uint32_t ipf, uint32_t trials, uint32_t warmup)
+{
+  Processor::Chip8 c8(rom.path.c_str());
+  c8.initialize();
+  c8.seed(1);
+  c8.setInstructionsPerFrame(ipf);
+
+  Processor::Chip8State start;
+  c8.save(start);
+  if ( !rom.program.empty() )
+  {
+    memcpy(start.memory + C8_MEMORY_OFFSET, &rom.program[0], rom.program.size());
+  }
+  c8.load(start);
+  c8.setEngine(engine);
+
+  for (uint32_t i = 0; i < warmup; ++i)
+  {
+    trial(c8, start, frames, ipf);
+  }
+  uint64_t idleBefore = c8.getIdleCycles();
+
+  std::vector<double> seconds;
+  for (uint32_t i = 0; i < trials; ++i)
+  {
+    seconds.push_back(trial(c8, start, frames, ipf));
+  }
+  std::sort(seconds.begin(), seconds.end());
+
+  Measurement result;
+  result.instructions = c8.getClock() - start.clock;
+  result.idle = (c8.getIdleCycles() - idleBefore) / trials;
+  result.halted = c8.halted;
+  result.median = seconds[seconds.size() / 2];
+  result.fastest = seconds.front();
+  result.slowest = seconds.back();
+  result.peakKilobytes = peakKilobytes();
+  return result;
+}
+
+// MIPS per ROM and engine, from the lines a previous run printed
+static std::map<std::string, double>
+readBaseline(const char *path)
+{
+  std::map<std::string, double> baseline;
+  std::ifstream file(path);
+  std::string line;
+  while ( std::getline(file, line) )
+  {
+    size_t rom = line.find("\"rom\":\"");
+    size_t engine = line.find("\"engine\":\"");
+    size_t mips = line.find("\"mips\":");
+    if ( rom == std::string::npos || engine == std::string::npos || mips == std::string::npos )
+    {
+      continue;
+    }
+    rom += 7;
+    engine += 10;
+    std::string key = line.substr(rom, line.find('"', rom) - rom) + " " + line.substr(engine, line.find('"', engine) - engine);
+    baseline[key] = atof(line.c_str() + mips + 7);
+  }
+  return baseline;
+}
+
+int
+main( const int argc, const char **argv )
+{
+  uint32_t frames = 100000;
+  uint32_t ipf = C8_INSTRUCTIONS_PER_FRAME;
+  uint32_t trials = 5;
+  uint32_t warmup = 1;
+  const char *baselineFile = NULL;
+  std::vector<Processor::Engine> engines;
+  std::vector<Rom> roms;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg.compare(0, 9, "--frames=") == 0)
+    {
+      frames = strtoul(argv[i] + 9, NULL, 10);
+    }
+    else if (arg.compare(0, 6, "--ipf=") == 0)
+    {
+      ipf = strtoul(argv[i] + 6, NULL, 10);
+    }
+    else if (arg.compare(0, 9, "--trials=") == 0)
+    {
+      trials = strtoul(argv[i] + 9, NULL, 10);
+    }
+    else if (arg.compare(0, 9, "--warmup=") == 0)
+    {
+      warmup = strtoul(argv[i] + 9, NULL, 10);
+    }
+    else if (arg.compare(0, 11, "--baseline=") == 0)
+    {
+      baselineFile = argv[i] + 11;
+    }
+    else if (arg == "--engine=dispatch")
+    {
+      engines.push_back(Processor::ENGINE_DISPATCH);
+    }
+    else if (arg == "--engine=threaded")
+    {
+      engines.push_back(Processor::ENGINE_THREADED);
+    }
+    else if (arg == "--engine=block")
+    {
+      engines.push_back(Processor::ENGINE_BLOCK);
+    }
+    else if (arg == "--engine=jit")
+    {
+      engines.push_back(Processor::ENGINE_JIT);
+    }
+    else if (arg == "--engine=all")
+    {
+      engines.clear();
+    }
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      std::cerr << "Usage: c8bench [--frames=<n>] [--ipf=<n>] [--trials=<n>] [--warmup=<n>] "
+                   "[--engine=all|dispatch|threaded|block|jit] [--baseline=<file>] [<ROM file> ...]" << std::endl;
+      return 1;
+    }
+    else
+    {
+      Rom rom;
+      rom.name = rom.path = argv[i];
+      if ( !std::ifstream(rom.path.c_str()) )
+      {
+        std::cerr << "c8bench: can't read " << rom.path << std::endl;
+        return 1;
+      }
+      roms.push_back(rom);
+    }
+  }
+
+  if ( trials == 0 )
+  {
+    trials = 1;
+  }
+  if ( ipf == 0 )
+  {
+    ipf = 1;
+  }
+
+  if ( engines.empty() )
+  {
+    engines.push_back(Processor::ENGINE_DISPATCH);
+    engines.push_back(Processor::ENGINE_THREADED);
+    engines.push_back(Processor::ENGINE_BLOCK);
+    engines.push_back(Processor::ENGINE_JIT);
+  }
+
+  if ( roms.empty() )
+  {
+    Rom pong;
+    pong.name = pong.path = "resources/pong";
+    roms.push_back(pong);
+    roms.push_back(synthetic("alu", alu, sizeof(alu)));
+    roms.push_back(synthetic("draw", draw, sizeof(draw)));
+    roms.push_back(synthetic("call", call, sizeof(call)));
+    roms.push_back(synthetic("fx", fx, sizeof(fx)));
+  }
+
+  std::map<std::string, double> baseline;
+  if ( baselineFile != NULL )
+  {
+    baseline = readBaseline(baselineFile);
+  }
+
+  for (size_t r = 0; r < roms.size(); ++r)
+  {
+    for (size_t e = 0; e < engines.size(); ++e)
+    {
+      Measurement result = measure(roms[r], engines[e], frames, ipf, trials, warmup);
+      double instructions = result.instructions > 0 ? (double)result.instructions : 1;
+      double mips = instructions / result.median / 1e6;
+
+      char line[512];
+      snprintf(line, sizeof(line),
+        "{\"rom\":\"%s\",\"engine\":\"%s\",\"frames\":%u,\"ipf\":%u,\"trials\":%u,\"instructions\":%llu,\"idle\":%llu,"
+        "\"halted\":%s,\"mips\":%.3f,\"mips_min\":%.3f,\"mips_max\":%.3f,\"ns_per_instruction\":%.3f,\"fps\":%.1f,"
+        "\"peak_rss_kb\":%ld}",
+        roms[r].name.c_str(), engineName(engines[e]), frames, ipf, trials,
+        (unsigned long long)result.instructions, (unsigned long long)result.idle, result.halted ? "true" : "false",
+        mips, instructions / result.slowest / 1e6, instructions / result.fastest / 1e6,
+        result.median * 1e9 / instructions, frames / result.median, result.peakKilobytes);
+      std::cout << line << std::endl;
+
+      std::map<std::string, double>::const_iterator before = baseline.find(roms[r].name + " " + engineName(engines[e]));
+      if ( before != baseline.end() && before->second > 0 )
+      {
+        fprintf(stderr, "%-20s %-9s %10.3f MIPS  %+6.1f%%\n", roms[r].name.c_str(), engineName(engines[e]),
+          mips, (mips / before->second - 1) * 100);
+      }
+    }
+  }
+  return 0;
+}
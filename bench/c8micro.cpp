@@ -0,0 +1,233 @@
+/*
+  c8micro - cost of each instruction handler on its own
+
+  Executes one opcode (or a short sequence, like a call and its return)
+  over and over through the same decode table and handler call the
+  dispatch engine uses, and reports host time per instruction: the
+  fastest and the median batch, in time stamp counter ticks on x86 (which
+  count at a fixed reference rate, not the core clock) or nanoseconds
+  elsewhere, and throughput in millions of instructions per second.
+
+  Every batch starts from a fresh copy of the processor plus the setup
+  opcodes of the benchmark, untimed, so handlers that walk memory (Fx65,
+  Fx1E) stay in bounds. The cost of reading the timer around an empty
+  batch is subtracted.
+
+  Usage: c8micro [--batches=<n>] [--json] [<name prefix> ...]
+*/
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "processor/chip8.hpp"
+#include "processor/precompiled.hpp"
+
+#define C8_MICRO_BATCH 256      // repetitions of a benchmark's opcodes per timed batch
+
+struct Benchmark
+{
+  const char *name;
+  uint16_t    setup[4];         // run before every batch, 0 ends the list
+  uint16_t    ops[2];           // timed, in turn
+  uint32_t    batch;            // repetitions per batch, C8_MICRO_BATCH unless memory runs out first
+};
+
+static const Benchmark benchmarks[] = {
+  { "cls",                         { 0 },                      { 0x00E0 },         C8_MICRO_BATCH },
+  { "call_ret",                    { 0 },                      { 0x2300, 0x00EE }, C8_MICRO_BATCH },
+  { "jp_addr",                     { 0 },                      { 0x1300 },         C8_MICRO_BATCH },
+  { "se_vx_byte",                  { 0 },                      { 0x3A00 },         C8_MICRO_BATCH },
+  { "ld_vx_byte",                  { 0 },                      { 0x6A12 },         C8_MICRO_BATCH },
+  { "add_vx_byte",                 { 0 },                      { 0x7A01 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/ld",      { 0x6A0F, 0x6B03 },         { 0x8AB0 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/or",      { 0x6A0F, 0x6B03 },         { 0x8AB1 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/and",     { 0x6A0F, 0x6B03 },         { 0x8AB2 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/xor",     { 0x6A0F, 0x6B03 },         { 0x8AB3 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/add",     { 0x6A0F, 0x6B03 },         { 0x8AB4 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/sub",     { 0x6A0F, 0x6B03 },         { 0x8AB5 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/shr",     { 0x6A0F, 0x6B03 },         { 0x8AB6 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/subn",    { 0x6A0F, 0x6B03 },         { 0x8AB7 },         C8_MICRO_BATCH },
+  { "register_vx_vy_byte/shl",     { 0x6A0F, 0x6B03 },         { 0x8ABE },         C8_MICRO_BATCH },
+  { "ld_i_addr",                   { 0 },                      { 0xA300 },         C8_MICRO_BATCH },
+  { "rnd_vx_byte",                 { 0 },                      { 0xCA7F },         C8_MICRO_BATCH },
+  { "drw_vx_vy_nibble/1",          { 0xA000, 0x6000, 0x6100 }, { 0xD011 },         C8_MICRO_BATCH },
+  { "drw_vx_vy_nibble/5",          { 0xA000, 0x6000, 0x6100 }, { 0xD015 },         C8_MICRO_BATCH },
+  { "drw_vx_vy_nibble/15",         { 0xA000, 0x6000, 0x6100 }, { 0xD01F },         C8_MICRO_BATCH },
+  { "drw_vx_vy_nibble/5 odd",      { 0xA000, 0x6003, 0x6100 }, { 0xD015 },         C8_MICRO_BATCH },
+  { "drw_vx_vy_nibble/5 wrap x",   { 0xA000, 0x603C, 0x6100 }, { 0xD015 },         C8_MICRO_BATCH },
+  { "drw_vx_vy_nibble/5 wrap y",   { 0xA000, 0x6000, 0x611E }, { 0xD015 },         C8_MICRO_BATCH },
+  { "drw_vx_vy_nibble/5 wrap xy",  { 0xA000, 0x603C, 0x611E }, { 0xD015 },         C8_MICRO_BATCH },
+  { "ex_skip/skp",                 { 0x6A05 },                 { 0xEA9E },         C8_MICRO_BATCH },
+  { "ex_skip/sknp",                { 0x6A05 },                 { 0xEAA1 },         C8_MICRO_BATCH },
+  { "fx_ld_vx_dt",                 { 0x6A3C, 0xFA15 },         { 0xF007 },         C8_MICRO_BATCH },
+  { "fx_ld_dt_vx",                 { 0x6A3C },                 { 0xFA15 },         C8_MICRO_BATCH },
+  { "fx_ld_st_vx",                 { 0x6A3C },                 { 0xFA18 },         C8_MICRO_BATCH },
+  { "fx_add_i_vx",                 { 0xA300, 0x6A01 },         { 0xFA1E },         C8_MICRO_BATCH },
+  { "fx_ld_f_vx",                  { 0x6A07 },                 { 0xFA29 },         C8_MICRO_BATCH },
+  { "fx_ld_b_vx",                  { 0xA300, 0x6AFE },         { 0xFA33 },         C8_MICRO_BATCH },
+  { "fx_ld_vx_i/1",                { 0xA300 },                 { 0xF065 },         C8_MICRO_BATCH },
+  { "fx_ld_vx_i/16",               { 0xA300 },                 { 0xFF65 },         64 },
+};
+
+// x86 time stamp counter, or nanoseconds where there is none
+static inline uint64_t
+ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static const char *
+tickUnit()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return "tsc";
+#else
+  return "ns";
+#endif
+}
+
+struct Timing
+{
+  double fastest;       // ticks per instruction
+  double median;
+  double mips;
+};
+
+static Timing
+measure(const Benchmark &benchmark, const Processor::Chip8State &start, uint32_t batches)
+{
+  Processor::Chip8 c8("");
+  c8.initialize();
+
+  size_t length = benchmark.ops[1] != 0 ? 2 : 1;
+  uint64_t instructions = (uint64_t)benchmark.batch * length;
+
+  // what reading the counter around nothing costs
+  uint64_t overhead = ~0ULL;
+  for (int i = 0; i < 1000; ++i)
+  {
+    uint64_t begin = ticks();
+    uint64_t end = ticks();
+    overhead = std::min(overhead, end - begin);
+  }
+
+  std::vector<double> perInstruction;
+  std::chrono::steady_clock::duration timed(0);
+  for (uint32_t b = 0; b < batches; ++b)
+  {
+    c8.load(start);
+    for (int i = 0; i < 4 && benchmark.setup[i] != 0; ++i)
+    {
+      Processor::Precompiled::execute(c8, benchmark.setup[i]);
+    }
+
+    std::chrono::steady_clock::time_point wall = std::chrono::steady_clock::now();
+    uint64_t begin = ticks();
+    for (uint32_t i = 0; i < benchmark.batch; ++i)
+    {
+      Processor::Precompiled::execute(c8, benchmark.ops[0]);
+      if ( length == 2 )
+      {
+        Processor::Precompiled::execute(c8, benchmark.ops[1]);
+      }
+    }
+    uint64_t end = ticks();
+    timed += std::chrono::steady_clock::now() - wall;
+
+    uint64_t elapsed = end - begin > overhead ? end - begin - overhead : 0;
+    perInstruction.push_back((double)elapsed / instructions);
+  }
+  std::sort(perInstruction.begin(), perInstruction.end());
+
+  Timing timing;
+  timing.fastest = perInstruction.front();
+  timing.median = perInstruction[perInstruction.size() / 2];
+  timing.mips = instructions * batches / std::chrono::duration<double>(timed).count() / 1e6;
+  return timing;
+}
+
+int
+main( const int argc, const char **argv )
+{
+  uint32_t batches = 2000;
+  bool json = false;
+  std::vector<std::string> prefixes;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg.compare(0, 10, "--batches=") == 0)
+    {
+      batches = strtoul(argv[i] + 10, NULL, 10);
+    }
+    else if (arg == "--json")
+    {
+      json = true;
+    }
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      std::cerr << "Usage: c8micro [--batches=<n>] [--json] [<name prefix> ...]" << std::endl;
+      return 1;
+    }
+    else
+    {
+      prefixes.push_back(arg);
+    }
+  }
+
+  if ( batches == 0 )
+  {
+    batches = 1;
+  }
+
+  // the state every batch starts from: fonts loaded, everything else zero
+  Processor::Chip8 image("");
+  image.initialize();
+  image.seed(1);
+  Processor::Chip8State start;
+  image.save(start);
+
+  if ( !json )
+  {
+    printf("%-28s %12s %12s %10s\n", "handler", (std::string(tickUnit()) + "/op min").c_str(),
+      (std::string(tickUnit()) + "/op median").c_str(), "MIPS");
+  }
+
+  for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); ++i)
+  {
+    const Benchmark &benchmark = benchmarks[i];
+    bool selected = prefixes.empty();
+    for (size_t p = 0; p < prefixes.size(); ++p)
+    {
+      selected = selected || std::string(benchmark.name).compare(0, prefixes[p].size(), prefixes[p]) == 0;
+    }
+    if ( !selected )
+    {
+      continue;
+    }
+
+    Timing timing = measure(benchmark, start, batches);
+    if ( json )
+    {
+      printf("{\"handler\":\"%s\",\"unit\":\"%s\",\"min\":%.3f,\"median\":%.3f,\"mips\":%.3f}\n",
+        benchmark.name, tickUnit(), timing.fastest, timing.median, timing.mips);
+    }
+    else
+    {
+      printf("%-28s %12.2f %12.2f %10.1f\n", benchmark.name, timing.fastest, timing.median, timing.mips);
+    }
+  }
+  return 0;
+}
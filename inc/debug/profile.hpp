@@ -0,0 +1,137 @@
+#ifndef __Profile
+#define __Profile 1
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+  Guest profiler, compiled in with -DC8_PROFILE (or `make PROFILE=on`, which
+  only builds c8 with it).
+  Counts every instruction cycle() executes by address, by opcode class
+  (the high nibble) and by operation, and every instruction an idle loop
+  or Fx0A wait skipped by the address it waited at. Without C8_PROFILE the
+  counting sites compile to nothing.
+
+  Calls and returns also drive a shadow call stack, see CallGraph.
+
+  The counters are shared by the whole process, meant for one processor
+  at a time.
+*/
+#define C8_PROFILE_ADDRESSES  4096
+#define C8_PROFILE_OPERATIONS 64        // at least Processor::OP_COUNT
+#define C8_PROFILE_MAX_DEPTH  16        // calls nested deeper are charged to the innermost tracked one
+
+namespace Debug
+{
+  struct Profile
+  {
+    uint64_t executed[C8_PROFILE_ADDRESSES];
+    uint64_t idle[C8_PROFILE_ADDRESSES];
+    uint16_t opCodes[C8_PROFILE_ADDRESSES];     // last opcode executed at each address
+    uint64_t classes[16];
+    uint64_t operations[C8_PROFILE_OPERATIONS];
+
+    inline void
+    instruction(uint16_t pc, uint16_t opCode, uint8_t operation)
+    {
+      pc &= C8_PROFILE_ADDRESSES - 1;
+      ++this->executed[pc];
+      this->opCodes[pc] = opCode;
+      ++this->classes[opCode >> 12];
+      ++this->operations[operation];
+    }
+
+    inline void
+    skipped(uint16_t pc, uint64_t cycles)
+    {
+      this->idle[pc & (C8_PROFILE_ADDRESSES - 1)] += cycles;
+    }
+
+    void clear();
+    void report(std::ostream &out, size_t top) const;
+    bool write(const char *path) const;
+  };
+
+  /*
+    Instructions and emulated time per CHIP-8 subroutine. 2nnn and 00EE
+    move through a tree with a node per distinct chain of calls from the
+    start of the program, and everything executed or skipped is charged
+    to the node of the subroutine running at the time, its exclusive
+    time. A subroutine's inclusive time adds that of every call it made.
+  */
+  class CallGraph
+  {
+    private:
+      struct Node
+      {
+        uint16_t address;         // where the subroutine starts, 0x200 for the root
+        uint32_t parent;
+        uint32_t firstChild;      // 0 for none, the root is never anyone's child
+        uint32_t nextSibling;
+        uint32_t depth;
+        uint64_t calls;
+        uint64_t instructions;    // executed in the subroutine itself
+        uint64_t idle;            // skipped in it, the rest of its emulated time
+      };
+
+      std::vector<Node> nodes;
+      uint32_t current;
+      uint32_t overflow;            // calls past C8_PROFILE_MAX_DEPTH not yet returned from
+
+      std::string path(uint32_t node) const;
+
+    public:
+      CallGraph();
+      void clear();
+      void report(std::ostream &out, size_t top) const;
+      void folded(std::ostream &out) const;
+      bool write(const char *path) const;
+
+      inline void
+      instruction()
+      {
+        ++this->nodes[this->current].instructions;
+      }
+
+      inline void
+      skipped(uint64_t cycles)
+      {
+        this->nodes[this->current].idle += cycles;
+      }
+
+      void call(uint16_t address);
+
+      inline void
+      ret()
+      {
+        if ( this->overflow > 0 )
+        {
+          --this->overflow;
+          return;
+        }
+        // a return without a call stays at the root
+        this->current = this->nodes[this->current].parent;
+      }
+  };
+
+  Profile &profile();
+  CallGraph &callGraph();
+}
+
+#ifdef C8_PROFILE
+  #define C8_PROFILE_INSTRUCTION(pc, opCode, operation) \
+    do { Debug::profile().instruction(pc, opCode, operation); Debug::callGraph().instruction(); } while (0)
+  #define C8_PROFILE_IDLE(pc, cycles) \
+    do { Debug::profile().skipped(pc, cycles); Debug::callGraph().skipped(cycles); } while (0)
+  #define C8_PROFILE_CALL(address) Debug::callGraph().call(address)
+  #define C8_PROFILE_RETURN()      Debug::callGraph().ret()
+#else
+  #define C8_PROFILE_INSTRUCTION(pc, opCode, operation) do { } while (0)
+  #define C8_PROFILE_IDLE(pc, cycles)                   do { } while (0)
+  #define C8_PROFILE_CALL(address)                      do { } while (0)
+  #define C8_PROFILE_RETURN()                           do { } while (0)
+#endif
+
+#endif
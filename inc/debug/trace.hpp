@@ -0,0 +1,43 @@
+#ifndef __Trace
+#define __Trace 1
+
+/*
+  Instruction tracing, chosen at compile time with -DC8_TRACE_LEVEL=...
+  (or `make TRACE=off|opcodes|state`):
+
+    C8_TRACE_OFF      trace sites compile to nothing
+    C8_TRACE_OPCODES  address, opcode and handler of every instruction
+    C8_TRACE_STATE    the above plus registers, I, sp and timers
+
+  Builds with tracing compiled in still only trace while the runtime
+  switch Debug::traceEnabled() is set (c8 --trace).
+*/
+#define C8_TRACE_OFF     0
+#define C8_TRACE_OPCODES 1
+#define C8_TRACE_STATE   2
+
+#ifndef C8_TRACE_LEVEL
+  #ifdef NDEBUG
+    #define C8_TRACE_LEVEL C8_TRACE_OFF
+  #else
+    #define C8_TRACE_LEVEL C8_TRACE_OPCODES
+  #endif
+#endif
+
+namespace Debug
+{
+  inline bool &
+  traceEnabled()
+  {
+    static bool enabled = false;
+    return enabled;
+  }
+}
+
+#if C8_TRACE_LEVEL > C8_TRACE_OFF
+  #define C8_TRACE(name) do { if ( Debug::traceEnabled() ) { this->trace(name); } } while (0)
+#else
+  #define C8_TRACE(name) do { } while (0)
+#endif
+
+#endif
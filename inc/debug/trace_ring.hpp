@@ -0,0 +1,98 @@
+#ifndef __TraceRing
+#define __TraceRing 1
+
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstdint>
+
+#define C8_TRACE_RING_SIZE   (1 << 16)     // records, must be a power of two
+#define C8_TRACE_MAGIC       "C8TR"
+#define C8_TRACE_VERSION     1
+#define C8_TRACE_NO_REGISTER 0xFF
+
+namespace Debug
+{
+  /*
+    One executed instruction. Written to trace files as is, in host byte
+    order, after a TraceHeader.
+  */
+  struct TraceRecord
+  {
+    uint32_t cycle;       // the emulated clock when it ran, low 32 bits
+    uint16_t pc;          // address the instruction was fetched from
+    uint16_t opCode;
+    uint16_t I;           // index register after the instruction
+    uint8_t  reg;         // lowest register the instruction changed, or C8_TRACE_NO_REGISTER
+    uint8_t  value;       // its new value
+  };
+
+  struct TraceHeader
+  {
+    char     magic[4];
+    uint16_t version;
+    uint16_t recordSize;
+  };
+
+  /*
+    Binary execution trace. The processor appends records to a preallocated
+    single producer, single consumer ring without locking or formatting, and
+    a background thread drains it to a file. When the ring is full the
+    processor waits for the writer rather than drop records.
+  */
+  class TraceRing
+  {
+    private:
+      TraceRecord *records;
+      std::atomic<uint64_t> head;       // next record the processor writes
+      std::atomic<uint64_t> tail;       // next record the writer drains
+      std::atomic<bool> stopping;
+      FILE *file;
+      std::thread writer;
+
+      void drain();
+
+    public:
+      TraceRing(FILE *file);
+      ~TraceRing();
+
+      static TraceRing *open(const char *path);
+
+      inline void
+      record(uint64_t cycle, uint16_t pc, uint16_t opCode, uint16_t I, const uint8_t *before, const uint8_t *after)
+      {
+        uint64_t at = this->head.load(std::memory_order_relaxed);
+        while ( at - this->tail.load(std::memory_order_acquire) >= C8_TRACE_RING_SIZE )
+        {
+          std::this_thread::yield();
+        }
+
+        TraceRecord &entry = this->records[at & (C8_TRACE_RING_SIZE - 1)];
+        entry.cycle  = (uint32_t)cycle;
+        entry.pc     = pc;
+        entry.opCode = opCode;
+        entry.I      = I;
+        entry.reg    = C8_TRACE_NO_REGISTER;
+        entry.value  = 0;
+        for (uint8_t i = 0; i < 16; ++i)
+        {
+          if ( before[i] != after[i] )
+          {
+            entry.reg   = i;
+            entry.value = after[i];
+            break;
+          }
+        }
+
+        this->head.store(at + 1, std::memory_order_release);
+      }
+  };
+
+  // name of the handler an operation (Processor::Operation) runs, as traced
+  const char *handlerName(uint8_t operation);
+
+  // false for the handlers that never printed themselves with the hexdump-based logging
+  bool handlerLogged(uint8_t operation);
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef __DISPLAY_BACKEND
+#define __DISPLAY_BACKEND 1
+
+#include <cstdint>
+#include <string>
+#include "input/keypad.hpp"
+
+#define PIXEL_BUFFER_SIZE 2048
+#define PIXEL_BUFFER_ROW  64
+
+namespace Display
+{
+
+  /*
+    Where frames go and input comes from. c8 only talks to this interface,
+    so it can run with or without a window. Only pixels that changed are
+    pushed, refresh() shows whatever was pushed since the last one.
+  */
+  class Backend
+  {
+
+    protected:
+      Input::Keypad *keypad;    // where key presses go, if anywhere
+
+    public:
+      Backend() : keypad(NULL) {}
+      virtual ~Backend() {}
+      void attach(Input::Keypad *keypad) { this->keypad = keypad; }
+      virtual void clearPixelBuffer() = 0;
+      virtual void pushToBuffer(int index, uint32_t pixel) = 0;
+      virtual void refresh() = 0;
+      virtual void inputManager() = 0;
+
+      // blocks until input arrives or `milliseconds` pass, true if anything arrived
+      virtual bool waitForInput(uint32_t milliseconds) { (void)milliseconds; return false; }
+
+      // shown to a person, so worth slowing emulation down to watch
+      virtual bool interactive() const { return false; }
+
+      // the person watching asked for emulation to stop for now
+      virtual bool paused() const { return false; }
+
+      // the person watching is done, the session should end
+      virtual bool closed() const { return false; }
+
+  };
+
+  /*
+    Discards every frame
+  */
+  class NullBackend : public Backend
+  {
+
+    public:
+      void clearPixelBuffer() {}
+      void pushToBuffer(int index, uint32_t pixel) { (void)index; (void)pixel; }
+      void refresh() {}
+      void inputManager() {}
+
+  };
+
+  /*
+    Keeps the last refreshed frame in memory
+  */
+  class FramebufferBackend : public Backend
+  {
+
+    private:
+      uint32_t pixelBuffer[PIXEL_BUFFER_SIZE];
+      uint32_t dirtyRows;                    // pushed to since the last refresh()
+
+    public:
+      uint32_t frame[PIXEL_BUFFER_SIZE];     // as of the last refresh()
+      uint32_t frames;                       // refresh() calls that changed the frame
+
+      FramebufferBackend();
+      void clearPixelBuffer();
+      void pushToBuffer(int index, uint32_t pixel);
+      void refresh();
+      void inputManager() {}
+      void print(std::string &out) const;
+
+  };
+
+  // "sdl", "null" or "framebuffer", NULL if the name is unknown or not built in
+  Backend *createBackend(const std::string &name);
+
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef __DISPLAY_FRAME_PACER
+#define __DISPLAY_FRAME_PACER 1
+
+#include <cstdint>
+#include <string>
+
+namespace Display
+{
+
+  /*
+    How late frames started, in nanoseconds
+  */
+  struct PacingStats
+  {
+    uint64_t frames;
+    uint64_t missed;      // deadlines passed by more than a whole frame, the pacer skipped ahead
+    double   mean;
+    double   deviation;
+    int64_t  worst;
+  };
+
+  /*
+    Starts frames on exact multiples of 1/hz from the first wait(). The
+    thread sleeps until `slack` before each deadline, since a sleep can
+    wake up late but rarely early, then spins the rest of the way.
+  */
+  class FramePacer
+  {
+
+    private:
+      int64_t period;
+      int64_t slack;
+      int64_t deadline;     // on the monotonic clock, 0 until the first wait()
+
+      uint64_t frames;
+      uint64_t missed;
+      double   mean;        // running mean and sum of squared differences (Welford)
+      double   squares;
+      int64_t  worst;
+
+      static int64_t now();
+      static void sleepUntil(int64_t time);
+
+    public:
+      FramePacer(uint32_t hz, uint32_t slackMicroseconds);
+      void wait();
+      void restart();
+      PacingStats stats() const;
+      void report(std::string &out) const;
+
+  };
+
+}
+
+#endif
@@ -3,15 +3,18 @@
 
 #include "SDL2/SDL.h"
 #include <iostream>
+#include "display/backend.hpp"
 
 #define WINDOW_HEIGHT 512
 #define WINDOW_WIDTH 1024
-#define PIXEL_BUFFER_SIZE 2048
 
 namespace Display
 {
 
-  class Screen
+  /*
+    SDL window backend
+  */
+  class Screen : public Backend
   {
 
     private:
@@ -20,6 +23,12 @@ namespace Display
       SDL_Renderer *renderer;
       SDL_Texture* sdlTexture;
       uint32_t pixelBuffer[PIXEL_BUFFER_SIZE];
+      uint32_t dirtyRows;       // pushed to since the last refresh()
+      bool exposed;             // the window lost its contents, present even if nothing changed
+      bool pausing;             // toggled with P
+      bool closing;             // the window was closed
+
+      void handle(const SDL_Event &event);
 
     public:
       Screen();
@@ -28,6 +37,10 @@ namespace Display
       void pushToBuffer(int index, uint32_t pixel);
       void refresh();
       void inputManager();
+      bool waitForInput(uint32_t milliseconds);
+      bool interactive() const { return true; }
+      bool paused() const { return this->pausing; }
+      bool closed() const { return this->closing; }
 
   };
 
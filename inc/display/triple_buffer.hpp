@@ -0,0 +1,70 @@
+#ifndef __DISPLAY_TRIPLE_BUFFER
+#define __DISPLAY_TRIPLE_BUFFER 1
+
+#include <atomic>
+#include <cstdint>
+#include "processor/state.hpp"
+
+namespace Display
+{
+
+  /*
+    One finished screen, as the processor keeps it
+  */
+  struct Frame
+  {
+    uint64_t rows[C8_GFX_WIDTH];
+  };
+
+  /*
+    Hands the latest of a stream of values from one thread to another
+    without either ever waiting. The writer fills back() and publishes it,
+    the reader picks up the most recently published value with update()
+    and reads front(). Values published in between are skipped, never torn.
+
+    Three slots: one the writer owns, one the reader owns and one in the
+    middle that they swap theirs with.
+  */
+  template<typename T>
+  class TripleBuffer
+  {
+
+    private:
+      static const uint8_t FRESH = 4;   // the middle slot was published since the reader last took it
+
+      alignas(64) T slots[3];
+      alignas(64) std::atomic<uint8_t> middle;
+      alignas(64) uint8_t back_;        // writer only
+      alignas(64) uint8_t front_;       // reader only
+
+    public:
+      TripleBuffer() : middle(1), back_(0), front_(2) {}
+
+      // writer
+      T &back() { return this->slots[this->back_]; }
+
+      void
+      publish()
+      {
+        this->back_ = this->middle.exchange(this->back_ | FRESH, std::memory_order_acq_rel) & 3;
+      }
+
+      // reader, true if front() changed
+      bool
+      update()
+      {
+        if ( !(this->middle.load(std::memory_order_relaxed) & FRESH) )
+        {
+          return false;
+        }
+        this->front_ = this->middle.exchange(this->front_, std::memory_order_acq_rel) & 3;
+        return true;
+      }
+
+      const T &front() const { return this->slots[this->front_]; }
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef __HOST_EMULATOR
+#define __HOST_EMULATOR 1
+
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <mutex>
+#include "display/backend.hpp"
+#include "display/frame_pacer.hpp"
+#include "display/triple_buffer.hpp"
+#include "input/keypad.hpp"
+#include "processor/chip8.hpp"
+
+namespace Host
+{
+
+  /*
+    How the window and processor threads keep each other informed
+  */
+  struct Signals
+  {
+    std::atomic<bool> running;        // cleared by the processor once it is done, or to stop it
+    std::atomic<bool> paused;         // set from the window
+    std::atomic<bool> blocked;        // the processor sleeps until input arrives
+    std::mutex lock;
+    std::condition_variable input;
+    uint64_t events;                  // input events handled so far, under lock
+  };
+
+  uint64_t inputEvents(Signals *signals);
+  void notifyInput(Signals *signals);
+  void waitForInput(Signals *signals, uint64_t seen);
+
+  // the rows that changed since the last frame, to the display
+  void present(const uint64_t *rows, uint32_t changed, Display::Backend *window);
+
+  // a frame published by the processor thread, `shown` is what the window shows so far
+  void present(const Display::Frame &frame, Display::Frame &shown, Display::Backend *window);
+
+  // SIGINT and SIGTERM, the session ends after the current frame like closing the window does
+  void requestStop(int);
+  bool stopRequested();
+
+  void emulate(Processor::Chip8 *c8, unsigned long cycles, Display::Backend *window, Input::Keypad *keypad,
+               Display::TripleBuffer<Display::Frame> *frames, Signals *signals, Display::FramePacer *pacer);
+
+#ifdef C8_PROFILE
+  extern const char *profileFile;
+  extern const char *callGraphFile;
+
+  // SIGUSR1, the processor thread dumps the profile after the current frame
+  void requestProfile(int);
+  void dumpProfile();
+#endif
+
+}
+
+#endif
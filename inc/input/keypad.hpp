@@ -0,0 +1,60 @@
+#ifndef __Input_Keypad
+#define __Input_Keypad 1
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#define C8_KEY_QUEUE_SIZE     256                   // events, must be a power of two
+#define C8_DEFAULT_KEY_LAYOUT "x123qweasdzc4rfv"    // host key for CHIP-8 keys 0 - F
+
+namespace Input
+{
+  /*
+    A key going down or up, stamped with when the host saw it
+  */
+  struct KeyEvent
+  {
+    int64_t time;         // nanoseconds on Input::clock()
+    uint8_t key;          // CHIP-8 key 0 - F
+    bool    down;
+  };
+
+  // the monotonic clock key events are stamped with
+  inline int64_t
+  clock()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /*
+    The hex keypad as seen from the host. Host keys are translated through
+    a configurable layout into timestamped events on a single producer,
+    single consumer ring: the window thread presses, the processor thread
+    takes events off and applies them at the matching point of emulated
+    time. A full ring drops new events rather than block the window.
+  */
+  class Keypad
+  {
+    private:
+      int32_t layout[16];               // host key code per CHIP-8 key
+      KeyEvent events[C8_KEY_QUEUE_SIZE];
+      alignas(64) std::atomic<uint32_t> head;   // next event pressed
+      alignas(64) std::atomic<uint32_t> tail;   // next event taken
+
+    public:
+      Keypad();
+      bool setLayout(const std::string &keys);
+      int key(int32_t hostKey) const;
+
+      // window thread
+      bool press(int32_t hostKey, bool down, int64_t time);
+
+      // processor thread
+      bool next(KeyEvent &event);
+  };
+}
+
+#endif
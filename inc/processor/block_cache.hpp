@@ -0,0 +1,51 @@
+#ifndef __Processor_BlockCache
+#define __Processor_BlockCache 1
+
+#include <vector>
+#include "processor/chip8.hpp"
+
+#define C8_BLOCK_MAX_OPS    64
+#define C8_BLOCK_MAX_STALE  1024    // invalidated blocks kept around before the cache is rebuilt
+
+namespace Processor
+{
+  /*
+    A run of straight-line code, up to and including the first jump, call,
+    return, skip or draw.
+  */
+  struct Block
+  {
+    uint16_t start;     // address of the first instruction
+    uint16_t end;       // address just past the last instruction
+    uint32_t first;     // index of the first micro-op in the cache's op pool
+    uint16_t length;    // number of micro-ops
+    bool     valid;
+  };
+
+  /*
+    Decoded blocks keyed by their starting address. Each micro-op points at
+    the shared decode table entry for its opcode, so running a block never
+    touches memory[] again.
+  */
+  class BlockCache
+  {
+    private:
+      std::vector<Block> blocks;
+      std::vector<const Chip8::Instruction *> ops;
+      int32_t  blockAt[4096];     // index into blocks starting at an address, -1 if none
+      uint16_t coverage[4096];    // number of valid blocks containing an address
+      uint32_t stale;
+
+    public:
+      uint32_t generation;        // bumped whenever a block is invalidated
+
+      BlockCache();
+      const Block *lookup(uint16_t address) const;
+      const Block *build(uint16_t address, const uint8_t *memory, const Chip8::Instruction *decodeTable);
+      const Chip8::Instruction * const *microOps(const Block *block) const;
+      void invalidate(uint16_t address, uint16_t length);
+      void flush();
+  };
+}
+
+#endif
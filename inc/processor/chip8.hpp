@@ -4,78 +4,216 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <random>
+#include <mutex>
 #include "time.h"
-#include <map>
 #include <iostream>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <fstream>
 #include "debug/hexdump.hpp"
+#include "processor/state.hpp"
+#include "debug/trace.hpp"
+#include "debug/trace_ring.hpp"
+#include "debug/profile.hpp"
 
 #define C8_MEMORY_OFFSET     512
 #define C8_MEMORY_OFFSET_HEX 0x200
 #define C8_EMULATION_SPEED_SLEEP 1200
-#define C8_GFX_LENGTH 64
-#define C8_GFX_WIDTH  32
-
-#define MASK(hex) ((this->opCode & hex))
+#define C8_OPCODE_COUNT 65536
 
 namespace Processor
 {
-	class Chip8
+  /*
+    Execution engines, selectable at runtime with Chip8::setEngine
+  */
+  enum Engine
+  {
+    ENGINE_DISPATCH,    // member function pointer per instruction, through cycle()
+    ENGINE_THREADED,    // direct-threaded loop using computed goto
+    ENGINE_BLOCK,       // cached, pre-decoded basic blocks
+    ENGINE_JIT,         // x86-64 recompiled blocks, interpreting whatever isn't compiled
+    ENGINE_PRECOMPILED  // blocks translated ahead of time by c8rc, interpreting the rest
+  };
+
+  /*
+    Loops that spin without changing anything until time passes or a key
+    changes, see Chip8::idleLoopAt
+  */
+  enum IdleLoop
+  {
+    IDLE_NONE,
+    IDLE_JUMP,          // 1nnn to itself
+    IDLE_KEY,           // Ex9E / ExA1 followed by a jump back to it, waiting for the key to change
+    IDLE_TIMER          // Fx07, 3x00 and a jump back, waiting for the delay timer to run out
+  };
+
+  /*
+    Every distinct operation the decoder can produce. The threaded engine
+    jumps on this, so the order must match its label table.
+  */
+  enum Operation
+  {
+    OP_UNIMPLEMENTED,
+    OP_CLS,
+    OP_RET,
+    OP_JP_ADDR,
+    OP_CALL_ADDR,
+    OP_SE_VX_BYTE,
+    OP_SNE_VX_BYTE,
+    OP_LD_VX_BYTE,
+    OP_ADD_VX_BYTE,
+    OP_LD_VX_VY,
+    OP_OR_VX_VY,
+    OP_AND_VX_VY,
+    OP_XOR_VX_VY,
+    OP_ADD_VX_VY,
+    OP_SUB_VX_VY,
+    OP_SHR_VX,
+    OP_SUBN_VX_VY,
+    OP_SHL_VX,
+    OP_LD_I_ADDR,
+    OP_RND_VX_BYTE,
+    OP_DRW_VX_VY_NIBBLE,
+    OP_SKP_VX,
+    OP_SKNP_VX,
+    OP_LD_VX_DT,
+    OP_LD_DT_VX,
+    OP_LD_ST_VX,
+    OP_ADD_I_VX,
+    OP_LD_F_VX,
+    OP_LD_B_VX,
+    OP_LD_VX_I,
+    OP_LD_VX_K,
+    OP_COUNT
+  };
+
+  class BlockCache;
+  class Jit;
+  class Precompiled;
+  template<int N> class Lanes;
+
+	/*
+    The machine state lives in the Chip8State base, this class adds how it
+    is run: decoding, the engines and their caches.
+  */
+	class Chip8 : protected Chip8State
 	{
 
     typedef void(Chip8::*instructionHandle)();
 
-    private:
-      uint16_t stack[16];         // Stack
-      uint16_t sp;                // Stack pointer
-      uint8_t  registers[16];     // 16 registers: 0 - F
-      uint16_t indexRegister;
-      uint16_t programCounter;
-      uint16_t opCode;
+    friend class Precompiled;
+    template<int N> friend class Lanes;
 
-      uint8_t delayTimer;                // Delay timer
-      uint8_t soundTimer;                // Sound timer
+    public:
+      /*
+        A pre-decoded opcode: the handler to run plus every operand field,
+        extracted once so handlers never have to mask the raw opcode. Most
+        handlers are instantiated per register, so they only read kk or nnn
+        from here.
+      */
+      struct Instruction
+      {
+        instructionHandle handler;
+        uint8_t  operation;   // Processor::Operation
+        uint16_t nnn;         // lowest 12 bits, address
+        uint8_t  x;           // lower 4 bits of the high byte
+        uint8_t  y;           // upper 4 bits of the low byte
+        uint8_t  n;           // lowest 4 bits, nibble
+        uint8_t  kk;          // lowest 8 bits, byte
+      };
 
+      static Instruction decode(uint16_t opCode);
+
+    private:
       std::string filename;
-      std::ifstream file;
-      std::map<uint16_t, instructionHandle> instructions;
-      std::map<uint16_t, instructionHandle> fxInstructions;   // there's a lot of 0xFxNN instructions
+      const Instruction *instruction;   // decoded form of opCode
+      Engine engine;
+      BlockCache *blockCache;           // only allocated for ENGINE_BLOCK
+      Jit *jit;                         // only allocated for ENGINE_JIT
+      Precompiled *precompiled;         // only allocated for ENGINE_PRECOMPILED
+      Debug::TraceRing *traceRing;      // only allocated while recording a binary trace
+      bool idling;                      // jumped into an idle loop or blocked on Fx0A, engines hand it back to run()
+      uint64_t idleCycles;              // instructions skipped rather than executed
+
+      // every possible opcode, decoded once and shared by all instances
+      static Instruction decodeTable[C8_OPCODE_COUNT];
+      static std::once_flag decodeTableBuilt;
+      static void buildDecodeTable();
 
     public:
 
-      bool     drawFlag; // tell the view to redraw the screen
-      uint8_t  graphicsBuffer[C8_GFX_LENGTH * C8_GFX_WIDTH];
-      uint8_t  memory[4096];      // 4k of memory
-      uint8_t  key[16]; // Keypad
+      using Chip8State::drawFlag;
+      using Chip8State::beepFlag;
+      using Chip8State::halted;
+      using Chip8State::graphicsBuffer;
+      using Chip8State::memory;
+      using Chip8State::key;
+      using Chip8State::pixel;
+      using Chip8State::dirtyRows;
 
       Chip8(const char *file_path);
+      ~Chip8();
       void initialize();
       void debugMemory();
       void cycle();
+      uint32_t run(uint32_t cycles);
+      void setEngine(Engine engine);
+      bool operator==(const Chip8 &other) const;
+      void invalidateCode(uint16_t address, uint16_t length);
+      bool recordTrace(const char *path);
+      void seed(uint32_t value);
+      void save(Chip8State &state) const;
+      void load(const Chip8State &state);
+      void setInstructionsPerFrame(uint32_t instructions);
+      void press(uint8_t key, bool down);
+
+      const uint8_t *getRegisters() const { return this->registers; }
+      uint16_t getIndexRegister() const   { return this->indexRegister; }
+      uint16_t getProgramCounter() const  { return this->programCounter; }
+      uint32_t getInstructionsPerFrame() const { return this->instructionsPerFrame; }
+      uint64_t getClock() const           { return this->clock; }
+      uint64_t getIdleCycles() const      { return this->idleCycles; }
+      Engine getEngine() const            { return this->engine; }
+      bool waitingForInput() const;
 
     protected:
+      uint32_t runDispatch(uint32_t cycles);
+      uint32_t runThreaded(uint32_t cycles);
+      uint32_t runBlocks(uint32_t cycles);
+      uint32_t runJit(uint32_t cycles);
+      uint32_t runPrecompiled(uint32_t cycles);
+      IdleLoop idleLoopAt(uint16_t address) const;
+      uint32_t skipIdle(uint32_t cycles);
+      bool awaitKey();
+      void draw(uint8_t x, uint8_t y, uint8_t height);
+      void storeBCD(uint8_t x);
+      void trace(const char *handler) const;
+
+      void unimplemented();
       void return_clear_screen();
       void fx_entrance();
-      void ex_skip();
-      void register_vx_vy_byte();
-      void fx_ld_b_vx();
-      void fx_ld_vx_i();
-      void fx_ld_f_vx();
-      void fx_ld_dt_vx();
-      void fx_ld_vx_dt();
-      void fx_ld_st_vx();
-      void fx_add_i_vx();
-      void ld_vx_byte();
       void ld_i_addr();
       void drw_vx_vy_nibble();
       void call_addr();
-      void add_vx_byte();
-      void se_vx_byte();
-      void sne_vx_byte();
       void jp_addr();
-      void rnd_vx_byte();
+
+      // specialized per register (and sub-operation) at compile time, see decode()
+      template<uint8_t X, uint8_t KK> void ex_skip();
+      template<uint8_t X, uint8_t Y, uint8_t N> void register_vx_vy_byte();
+      template<uint8_t X> void fx_ld_b_vx();
+      template<uint8_t X> void fx_ld_vx_i();
+      template<uint8_t X> void fx_ld_f_vx();
+      template<uint8_t X> void fx_ld_dt_vx();
+      template<uint8_t X> void fx_ld_vx_dt();
+      template<uint8_t X> void fx_ld_st_vx();
+      template<uint8_t X> void fx_ld_vx_k();
+      template<uint8_t X> void fx_add_i_vx();
+      template<uint8_t X> void ld_vx_byte();
+      template<uint8_t X> void add_vx_byte();
+      template<uint8_t X> void se_vx_byte();
+      template<uint8_t X> void sne_vx_byte();
+      template<uint8_t X> void rnd_vx_byte();
 
 	};
 }
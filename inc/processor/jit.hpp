@@ -0,0 +1,92 @@
+#ifndef __Processor_Jit
+#define __Processor_Jit 1
+
+#include <vector>
+#include "processor/chip8.hpp"
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+  #define C8_JIT_SUPPORTED 1
+#endif
+
+#define C8_JIT_BUFFER_SIZE (4 * 1024 * 1024)
+#define C8_JIT_MAX_OPS     64
+#define C8_JIT_BLOCK_SPACE (16 * 1024)    // more than the largest block can need
+#define C8_JIT_GUEST_I     16             // guest register index used for I
+
+namespace Processor
+{
+  /*
+    Guest state shared with compiled code. Compiled blocks address these
+    fields by fixed offsets from rdi, so keep the layout in sync with jit.cpp.
+  */
+  struct JitContext
+  {
+    uint8_t  V[16];       // 0
+    uint16_t I;           // 16
+    uint16_t pc;          // 18, where to continue once compiled code returns
+    int32_t  budget;      // 20, instructions compiled code may still execute
+    uint32_t executed;    // 24, instructions compiled code did execute
+  };
+
+  /*
+    x86-64 dynamic recompiler.
+
+    Straight-line runs of ALU, load, skip and jump instructions are compiled
+    into an executable buffer. Guest registers used by a block live in host
+    registers for the whole block and are written back at its exits, and
+    exits to a known address are patched to jump directly into the next
+    block. Anything else (draw, call/return, timers, memory, keys) is left
+    to the interpreter.
+  */
+  class Jit
+  {
+    private:
+      struct Link
+      {
+        size_t   at;        // offset of the rel32 to patch
+        uint16_t target;    // guest address it should jump to
+      };
+
+      uint8_t *buffer;
+      size_t   used;
+      size_t   codeStart;                   // first byte after the enter/exit trampolines
+      uint8_t *exitCode;                    // restores the host registers and returns
+      uint8_t *blockAt[4096];               // compiled entry point per guest address
+      bool     uncompilable[4096];          // first instruction at the address can't be compiled
+      bool     covered[4096];               // guest bytes some compiled code depends on
+      std::vector<Link> links;              // exits waiting for their target to be compiled
+
+      uint8_t *compile(uint16_t address, const uint8_t *memory, const Chip8::Instruction *decodeTable);
+      void emitExit(uint16_t target, uint32_t executed, const int8_t *host, const bool *dirty);
+      void patch(size_t at, const uint8_t *target);
+
+      void emit(uint8_t byte);
+      void emit16(uint16_t value);
+      void emit32(uint32_t value);
+      void rex(int reg, int rm, bool force);
+      void movRegImm(int reg, uint32_t value);
+      void aluRegReg(uint8_t opcode, int dst, int src);
+      void aluRegImm(uint8_t extension, int reg, uint32_t value);
+      void aluMemImm(uint8_t extension, uint8_t offset, uint32_t value);
+      void shiftRegImm(uint8_t extension, int reg, uint8_t count);
+      void imulRegRegImm(int dst, int src, int8_t value);
+      void loadByte(int reg, uint8_t offset);
+      void loadWord(int reg, uint8_t offset);
+      void storeByte(uint8_t offset, int reg);
+      void storeWord(uint8_t offset, int reg);
+      void storeWordImm(uint8_t offset, uint16_t value);
+      size_t jump();
+      size_t jumpIf(uint8_t condition);
+
+    public:
+      Jit();
+      ~Jit();
+      bool ready() const;
+      const uint8_t *lookup(uint16_t address, const uint8_t *memory, const Chip8::Instruction *decodeTable);
+      void enter(JitContext *context, const uint8_t *code);
+      void invalidate(uint16_t address, uint16_t length);
+      void flush();
+  };
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef __Processor_Lanes
+#define __Processor_Lanes 1
+
+#include "processor/chip8.hpp"
+
+namespace Processor
+{
+  /*
+    N instances of one ROM executing in lockstep (8, 16 or 32 lanes).
+
+    State is kept as structure of arrays with the lane as the innermost
+    index, so one instruction updates every lane with a single pass over
+    contiguous bytes, which the compiler turns into SIMD code for whatever
+    instruction set it targets (AVX2, AVX-512, or plain scalar code). That
+    takes optimizations: make c8batch builds with -O3 -march=native, see
+    BATCHARCH in the Makefile.
+
+    Like a SIMT core, every step executes the instruction at the lowest
+    program counter of any running lane. Lanes at another address, or whose
+    memory holds a different opcode there, sit the step out and rejoin
+    once control flow brings them back together. Each lane behaves exactly
+    like a Chip8 with the same seed and keys, at the default instructions
+    per frame.
+  */
+  template<int N>
+  class Lanes
+  {
+    private:
+      uint8_t  V[16][N];
+      uint16_t I[N];
+      uint16_t pc[N];
+      uint16_t sp[N];
+      uint16_t stack[16][N];
+      uint64_t delayExpires[N];     // frame the timer runs out in, see timer()
+      uint64_t soundExpires[N];     // 0 while silent
+      uint8_t  keyWait[N];          // as in Chip8State, C8_KEY_WAIT | x while blocked on Fx0A
+      uint8_t  keyHeld[N];
+      uint8_t  active[N];           // non zero for lanes executing the current instruction
+      uint32_t remaining[N];        // instructions each lane still has to execute in run()
+      uint64_t instructions[N];     // instructions each lane executed so far
+      uint32_t random[N];           // RND state per lane, see seedRandom()
+      uint8_t  memory[N][4096];
+
+      void execute(const Chip8::Instruction &op);
+      void draw(int lane, uint8_t x, uint8_t y, uint8_t height);
+      uint64_t frame(int lane) const { return this->instructions[lane] / C8_INSTRUCTIONS_PER_FRAME; }
+      uint8_t timer(uint64_t expires, int lane) const;
+      void settleSound(int lane);
+      bool awaitKey(int lane);
+
+    public:
+      uint64_t graphicsBuffer[N][C8_GFX_WIDTH];     // rows, as in Chip8State
+      uint8_t  key[N][16];
+      bool     drawFlag[N];
+      bool     beepFlag[N];
+      bool     halted[N];
+
+      Lanes(const char *file_path);
+      void seed(int lane, uint32_t value);
+      void press(int lane, uint8_t key, bool down);
+      uint64_t run(uint32_t cycles);
+      bool matches(int lane, const Chip8 &c8) const;
+      uint16_t getProgramCounter(int lane) const { return this->pc[lane]; }
+      uint16_t getIndexRegister(int lane) const  { return this->I[lane]; }
+      uint8_t  getRegister(int lane, int x) const { return this->V[x][lane]; }
+      uint64_t getInstructions(int lane) const    { return this->instructions[lane]; }
+  };
+}
+
+#endif
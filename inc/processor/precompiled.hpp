@@ -0,0 +1,68 @@
+#ifndef __Processor_Precompiled
+#define __Processor_Precompiled 1
+
+#include <vector>
+#include "processor/chip8.hpp"
+
+namespace Processor
+{
+  /*
+    One basic block of a ROM translated to C++ by c8rc. Every path through
+    `run` executes exactly `length` instructions and leaves the program
+    counter at the block's successor.
+  */
+  struct PrecompiledBlock
+  {
+    uint16_t start;     // address of the first instruction
+    uint16_t end;       // address just past the last instruction
+    uint16_t length;    // instructions executed
+    void (*run)(Chip8 &c8);
+  };
+
+  /*
+    Everything c8rc generated for one ROM
+  */
+  struct PrecompiledRom
+  {
+    const char    *name;
+    const uint8_t *image;     // the ROM the blocks were translated from
+    uint16_t       size;
+    const PrecompiledBlock *blocks;
+    uint16_t       count;
+  };
+
+  /*
+    Runtime support for code generated by c8rc: a registry generated
+    translation units add themselves to, the per-processor lookup table of
+    blocks that still match memory, and the accessors the generated code
+    uses to reach the processor's state.
+  */
+  class Precompiled
+  {
+    private:
+      const PrecompiledRom   *rom;
+      const PrecompiledBlock *blockAt[4096];
+
+      static std::vector<const PrecompiledRom *> &registry();
+
+    public:
+      Precompiled(const PrecompiledRom *rom);
+      const PrecompiledBlock *lookup(uint16_t address) const;
+      void invalidate(uint16_t address, uint16_t length);
+
+      static void add(const PrecompiledRom *rom);
+      static const PrecompiledRom *find(const uint8_t *memory);
+
+      // used by generated code
+      static uint8_t  *V(Chip8 &c8)       { return c8.registers; }
+      static uint16_t &I(Chip8 &c8)       { return c8.indexRegister; }
+      static uint16_t &pc(Chip8 &c8)      { return c8.programCounter; }
+      static uint16_t *stack(Chip8 &c8)   { return c8.stack; }
+      static uint16_t &sp(Chip8 &c8)      { return c8.sp; }
+      static uint8_t  *memory(Chip8 &c8)  { return c8.memory; }
+      static void tick(Chip8 &c8, uint32_t ticks) { c8.clock += ticks; }
+      static void execute(Chip8 &c8, uint16_t opCode);
+  };
+}
+
+#endif
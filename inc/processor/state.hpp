@@ -0,0 +1,159 @@
+#ifndef __Processor_State
+#define __Processor_State 1
+
+#include <cstdint>
+#include <type_traits>
+
+#define C8_GFX_LENGTH 64
+#define C8_GFX_WIDTH  32
+
+// DT and ST count down at 60 Hz of emulated time, a frame being this many instructions by default
+#define C8_TIMER_HZ               60
+#define C8_INSTRUCTIONS_PER_FRAME 10
+
+// Chip8State::keyWait while Fx0A blocks, with the register the key goes to in the low nibble
+#define C8_KEY_WAIT 0x10
+#define C8_NO_KEY   0xFF
+
+namespace Processor
+{
+  /*
+    Everything a CHIP-8 machine is, and nothing of how it is being run.
+    Trivially copyable, so a snapshot is one memcpy and instances can be
+    laid out back to back. What every instruction touches comes first and
+    fits in the first cache line.
+  */
+  struct alignas(64) Chip8State
+  {
+    uint8_t  registers[16];     // 16 registers: 0 - F
+    uint16_t indexRegister;
+    uint16_t programCounter;
+    uint16_t sp;                // Stack pointer
+    uint16_t opCode;
+    uint64_t clock;             // instructions executed so far, the emulated time
+    bool     drawFlag;          // tell the view to redraw the screen
+    bool     beepFlag;          // the sound timer ran out, tell the view to beep
+    bool     halted;            // stopped on an unimplemented opcode, run() does nothing from here on
+    uint8_t  keyWait;           // C8_KEY_WAIT | x while Fx0A waits for a key to go into Vx, 0 otherwise
+    uint8_t  keyHeld;           // the key pressed since Fx0A started waiting, C8_NO_KEY until then
+    uint16_t stack[16];         // Stack
+
+    uint32_t random;            // RND state, per processor so instances never share it
+    uint32_t dirtyRows;         // bit n set when row n changed, cleared by whoever shows the screen
+    uint32_t instructionsPerFrame;
+    uint64_t delayExpires;      // frame DT reaches 0 in, see delayTimer()
+    uint64_t soundExpires;      // frame ST runs out in, 0 while silent
+    uint8_t  key[16];           // Keypad
+
+    // one row per word, the leftmost pixel in the most significant bit
+    uint64_t graphicsBuffer[C8_GFX_WIDTH];
+    uint8_t  memory[4096];      // 4k of memory
+
+    bool
+    pixel(int x, int y) const
+    {
+      return (this->graphicsBuffer[y] >> (C8_GFX_LENGTH - 1 - x)) & 1;
+    }
+
+    /*
+      The timers are never ticked. Setting one records the frame it runs
+      out in, and reading it counts the frames left from the clock, so
+      instructions that don't touch them cost nothing extra.
+    */
+    uint64_t
+    frame() const
+    {
+      return this->clock / this->instructionsPerFrame;
+    }
+
+    uint8_t
+    delayTimer() const
+    {
+      uint64_t now = this->frame();
+      return this->delayExpires > now ? this->delayExpires - now : 0;
+    }
+
+    uint8_t
+    soundTimer() const
+    {
+      uint64_t now = this->frame();
+      return this->soundExpires > now ? this->soundExpires - now : 0;
+    }
+
+    void
+    setDelayTimer(uint8_t value)
+    {
+      this->delayExpires = this->frame() + value;
+    }
+
+    void
+    setSoundTimer(uint8_t value)
+    {
+      // a sound timer running out before this one replaces it still beeps
+      this->settleSound();
+      this->soundExpires = value != 0 ? this->frame() + value : 0;
+    }
+
+    // raises beepFlag once the sound timer has run out
+    void
+    settleSound()
+    {
+      if ( this->soundExpires != 0 && this->frame() >= this->soundExpires )
+      {
+        // BEEP!
+        this->beepFlag = true;
+        this->soundExpires = 0;
+      }
+    }
+
+    void
+    clearScreen()
+    {
+      for (int row = 0; row < C8_GFX_WIDTH; ++row)
+      {
+        if ( this->graphicsBuffer[row] != 0 )
+        {
+          this->dirtyRows |= 1U << row;
+          this->graphicsBuffer[row] = 0;
+        }
+      }
+    }
+  };
+
+  // POD rather than just trivially copyable: a derived class must not reuse its padding
+  static_assert(std::is_pod<Chip8State>::value, "Chip8State must be plain old data");
+
+  /*
+    A byte of sprite data as a framebuffer row with its leftmost pixel in
+    `column`, wrapping around at the right edge of the screen
+  */
+  inline uint64_t
+  spriteRow(uint8_t bits, unsigned int column)
+  {
+    uint64_t row = (uint64_t)bits << (C8_GFX_LENGTH - 8);
+    column %= C8_GFX_LENGTH;
+    return column == 0 ? row : (row >> column) | (row << (C8_GFX_LENGTH - column));
+  }
+
+  /*
+    The same sequence as std::minstd_rand, on a plain integer
+  */
+  inline void
+  seedRandom(uint32_t &state, uint32_t value)
+  {
+    state = value % 2147483647U;
+    if ( state == 0 )
+    {
+      state = 1;
+    }
+  }
+
+  inline uint32_t
+  nextRandom(uint32_t &state)
+  {
+    state = (uint32_t)(((uint64_t)state * 48271U) % 2147483647U);
+    return state;
+  }
+}
+
+#endif
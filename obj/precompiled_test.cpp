@@ -0,0 +1,1345 @@
+// Generated by c8rc from resources/pong, do not edit
+#include "processor/precompiled.hpp"
+
+namespace
+{
+
+const uint8_t image[] = {
+  0x6a, 0x02, 0x6b, 0x0c, 0x6c, 0x3f, 0x6d, 0x0c, 0xa2, 0xea, 0xda, 0xb6, 0xdc, 0xd6, 0x6e, 0x00,
+  0x22, 0xd4, 0x66, 0x03, 0x68, 0x02, 0x60, 0x60, 0xf0, 0x15, 0xf0, 0x07, 0x30, 0x00, 0x12, 0x1a,
+  0xc7, 0x17, 0x77, 0x08, 0x69, 0xff, 0xa2, 0xf0, 0xd6, 0x71, 0xa2, 0xea, 0xda, 0xb6, 0xdc, 0xd6,
+  0x60, 0x01, 0xe0, 0xa1, 0x7b, 0xfe, 0x60, 0x04, 0xe0, 0xa1, 0x7b, 0x02, 0x60, 0x1f, 0x8b, 0x02,
+  0xda, 0xb6, 0x60, 0x0c, 0xe0, 0xa1, 0x7d, 0xfe, 0x60, 0x0d, 0xe0, 0xa1, 0x7d, 0x02, 0x60, 0x1f,
+  0x8d, 0x02, 0xdc, 0xd6, 0xa2, 0xf0, 0xd6, 0x71, 0x86, 0x84, 0x87, 0x94, 0x60, 0x3f, 0x86, 0x02,
+  0x61, 0x1f, 0x87, 0x12, 0x46, 0x02, 0x12, 0x78, 0x46, 0x3f, 0x12, 0x82, 0x47, 0x1f, 0x69, 0xff,
+  0x47, 0x00, 0x69, 0x01, 0xd6, 0x71, 0x12, 0x2a, 0x68, 0x02, 0x63, 0x01, 0x80, 0x70, 0x80, 0xb5,
+  0x12, 0x8a, 0x68, 0xfe, 0x63, 0x0a, 0x80, 0x70, 0x80, 0xd5, 0x3f, 0x01, 0x12, 0xa2, 0x61, 0x02,
+  0x80, 0x15, 0x3f, 0x01, 0x12, 0xba, 0x80, 0x15, 0x3f, 0x01, 0x12, 0xc8, 0x80, 0x15, 0x3f, 0x01,
+  0x12, 0xc2, 0x60, 0x20, 0xf0, 0x18, 0x22, 0xd4, 0x8e, 0x34, 0x22, 0xd4, 0x66, 0x3e, 0x33, 0x01,
+  0x66, 0x03, 0x68, 0xfe, 0x33, 0x01, 0x68, 0x02, 0x12, 0x16, 0x79, 0xff, 0x49, 0xfe, 0x69, 0xff,
+  0x12, 0xc8, 0x79, 0x01, 0x49, 0x02, 0x69, 0x01, 0x60, 0x04, 0xf0, 0x18, 0x76, 0x01, 0x46, 0x40,
+  0x76, 0xfe, 0x12, 0x6c, 0xa2, 0xf2, 0xfe, 0x33, 0xf2, 0x65, 0xf1, 0x29, 0x64, 0x14, 0x65, 0x00,
+  0xd4, 0x55, 0x74, 0x15, 0xf2, 0x29, 0xd4, 0x55, 0x00, 0xee, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// 0x200 - 0x20C
+static void
+block_200(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x200: 6a02
+  V[0xA] = 0x02;
+  // 0x202: 6b0c
+  V[0xB] = 0x0C;
+  // 0x204: 6c3f
+  V[0xC] = 0x3F;
+  // 0x206: 6d0c
+  V[0xD] = 0x0C;
+  // 0x208: a2ea
+  I = 0x2EA;
+  // 0x20A: dab6
+  Processor::Precompiled::tick(c8, 5);
+  pc = 0x20A;
+  Processor::Precompiled::execute(c8, 0xDAB6);
+}
+
+// 0x20C - 0x20E
+static void
+block_20C(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x20C: dcd6
+  pc = 0x20C;
+  Processor::Precompiled::execute(c8, 0xDCD6);
+}
+
+// 0x20E - 0x212
+static void
+block_20E(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x20E: 6e00
+  V[0xE] = 0x00;
+  // 0x210: 22d4
+  stack[sp & 0xF] = 0x210;
+  ++sp;
+  pc = 0x2D4;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x212 - 0x21E
+static void
+block_212(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x212: 6603
+  V[0x6] = 0x03;
+  // 0x214: 6802
+  V[0x8] = 0x02;
+  // 0x216: 6060
+  V[0x0] = 0x60;
+  // 0x218: f015
+  Processor::Precompiled::tick(c8, 3);
+  pc = 0x218;
+  Processor::Precompiled::execute(c8, 0xF015);
+  // 0x21A: f007
+  pc = 0x21A;
+  Processor::Precompiled::execute(c8, 0xF007);
+  // 0x21C: 3000
+  pc = ( V[0x0] == 0x00 ) ? 0x220 : 0x21E;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x216 - 0x21E
+static void
+block_216(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x216: 6060
+  V[0x0] = 0x60;
+  // 0x218: f015
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x218;
+  Processor::Precompiled::execute(c8, 0xF015);
+  // 0x21A: f007
+  pc = 0x21A;
+  Processor::Precompiled::execute(c8, 0xF007);
+  // 0x21C: 3000
+  pc = ( V[0x0] == 0x00 ) ? 0x220 : 0x21E;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x21A - 0x21E
+static void
+block_21A(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x21A: f007
+  pc = 0x21A;
+  Processor::Precompiled::execute(c8, 0xF007);
+  // 0x21C: 3000
+  pc = ( V[0x0] == 0x00 ) ? 0x220 : 0x21E;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x21E - 0x220
+static void
+block_21E(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x21E: 121a
+  pc = 0x21A;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x220 - 0x22A
+static void
+block_220(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x220: c717
+  pc = 0x220;
+  Processor::Precompiled::execute(c8, 0xC717);
+  // 0x222: 7708
+  V[0x7] += 0x08;
+  // 0x224: 69ff
+  V[0x9] = 0xFF;
+  // 0x226: a2f0
+  I = 0x2F0;
+  // 0x228: d671
+  Processor::Precompiled::tick(c8, 3);
+  pc = 0x228;
+  Processor::Precompiled::execute(c8, 0xD671);
+}
+
+// 0x22A - 0x22E
+static void
+block_22A(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x22A: a2ea
+  I = 0x2EA;
+  // 0x22C: dab6
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x22C;
+  Processor::Precompiled::execute(c8, 0xDAB6);
+}
+
+// 0x22E - 0x230
+static void
+block_22E(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x22E: dcd6
+  pc = 0x22E;
+  Processor::Precompiled::execute(c8, 0xDCD6);
+}
+
+// 0x230 - 0x234
+static void
+block_230(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x230: 6001
+  V[0x0] = 0x01;
+  // 0x232: e0a1
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x232;
+  Processor::Precompiled::execute(c8, 0xE0A1);
+}
+
+// 0x234 - 0x23A
+static void
+block_234(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x234: 7bfe
+  V[0xB] += 0xFE;
+  // 0x236: 6004
+  V[0x0] = 0x04;
+  // 0x238: e0a1
+  Processor::Precompiled::tick(c8, 2);
+  pc = 0x238;
+  Processor::Precompiled::execute(c8, 0xE0A1);
+}
+
+// 0x236 - 0x23A
+static void
+block_236(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x236: 6004
+  V[0x0] = 0x04;
+  // 0x238: e0a1
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x238;
+  Processor::Precompiled::execute(c8, 0xE0A1);
+}
+
+// 0x23A - 0x242
+static void
+block_23A(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x23A: 7b02
+  V[0xB] += 0x02;
+  // 0x23C: 601f
+  V[0x0] = 0x1F;
+  // 0x23E: 8b02
+  V[0xB] &= V[0x0];
+  // 0x240: dab6
+  Processor::Precompiled::tick(c8, 3);
+  pc = 0x240;
+  Processor::Precompiled::execute(c8, 0xDAB6);
+}
+
+// 0x23C - 0x242
+static void
+block_23C(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x23C: 601f
+  V[0x0] = 0x1F;
+  // 0x23E: 8b02
+  V[0xB] &= V[0x0];
+  // 0x240: dab6
+  Processor::Precompiled::tick(c8, 2);
+  pc = 0x240;
+  Processor::Precompiled::execute(c8, 0xDAB6);
+}
+
+// 0x242 - 0x246
+static void
+block_242(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x242: 600c
+  V[0x0] = 0x0C;
+  // 0x244: e0a1
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x244;
+  Processor::Precompiled::execute(c8, 0xE0A1);
+}
+
+// 0x246 - 0x24C
+static void
+block_246(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x246: 7dfe
+  V[0xD] += 0xFE;
+  // 0x248: 600d
+  V[0x0] = 0x0D;
+  // 0x24A: e0a1
+  Processor::Precompiled::tick(c8, 2);
+  pc = 0x24A;
+  Processor::Precompiled::execute(c8, 0xE0A1);
+}
+
+// 0x248 - 0x24C
+static void
+block_248(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x248: 600d
+  V[0x0] = 0x0D;
+  // 0x24A: e0a1
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x24A;
+  Processor::Precompiled::execute(c8, 0xE0A1);
+}
+
+// 0x24C - 0x254
+static void
+block_24C(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x24C: 7d02
+  V[0xD] += 0x02;
+  // 0x24E: 601f
+  V[0x0] = 0x1F;
+  // 0x250: 8d02
+  V[0xD] &= V[0x0];
+  // 0x252: dcd6
+  Processor::Precompiled::tick(c8, 3);
+  pc = 0x252;
+  Processor::Precompiled::execute(c8, 0xDCD6);
+}
+
+// 0x24E - 0x254
+static void
+block_24E(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x24E: 601f
+  V[0x0] = 0x1F;
+  // 0x250: 8d02
+  V[0xD] &= V[0x0];
+  // 0x252: dcd6
+  Processor::Precompiled::tick(c8, 2);
+  pc = 0x252;
+  Processor::Precompiled::execute(c8, 0xDCD6);
+}
+
+// 0x254 - 0x258
+static void
+block_254(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x254: a2f0
+  I = 0x2F0;
+  // 0x256: d671
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x256;
+  Processor::Precompiled::execute(c8, 0xD671);
+}
+
+// 0x258 - 0x266
+static void
+block_258(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x258: 8684
+  V[0x6] += V[0x8];
+  V[0xF] = 0;
+  if ( V[0x8] > (0xFF - V[0x6]) ) V[0xF] = 1;
+  // 0x25A: 8794
+  V[0x7] += V[0x9];
+  V[0xF] = 0;
+  if ( V[0x9] > (0xFF - V[0x7]) ) V[0xF] = 1;
+  // 0x25C: 603f
+  V[0x0] = 0x3F;
+  // 0x25E: 8602
+  V[0x6] &= V[0x0];
+  // 0x260: 611f
+  V[0x1] = 0x1F;
+  // 0x262: 8712
+  V[0x7] &= V[0x1];
+  // 0x264: 4602
+  pc = ( V[0x6] != 0x02 ) ? 0x268 : 0x266;
+  Processor::Precompiled::tick(c8, 7);
+}
+
+// 0x266 - 0x268
+static void
+block_266(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x266: 1278
+  pc = 0x278;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x268 - 0x26A
+static void
+block_268(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x268: 463f
+  pc = ( V[0x6] != 0x3F ) ? 0x26C : 0x26A;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x26A - 0x26C
+static void
+block_26A(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x26A: 1282
+  pc = 0x282;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x26C - 0x26E
+static void
+block_26C(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x26C: 471f
+  pc = ( V[0x7] != 0x1F ) ? 0x270 : 0x26E;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x26E - 0x272
+static void
+block_26E(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x26E: 69ff
+  V[0x9] = 0xFF;
+  // 0x270: 4700
+  pc = ( V[0x7] != 0x00 ) ? 0x274 : 0x272;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x270 - 0x272
+static void
+block_270(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x270: 4700
+  pc = ( V[0x7] != 0x00 ) ? 0x274 : 0x272;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x272 - 0x276
+static void
+block_272(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x272: 6901
+  V[0x9] = 0x01;
+  // 0x274: d671
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x274;
+  Processor::Precompiled::execute(c8, 0xD671);
+}
+
+// 0x274 - 0x276
+static void
+block_274(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x274: d671
+  pc = 0x274;
+  Processor::Precompiled::execute(c8, 0xD671);
+}
+
+// 0x276 - 0x278
+static void
+block_276(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x276: 122a
+  pc = 0x22A;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x278 - 0x282
+static void
+block_278(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x278: 6802
+  V[0x8] = 0x02;
+  // 0x27A: 6301
+  V[0x3] = 0x01;
+  // 0x27C: 8070
+  V[0x0] = V[0x7];
+  // 0x27E: 80b5
+  V[0xF] = 1;
+  if ( V[0xB] > V[0x0] ) V[0xF] = 0;
+  V[0x0] -= V[0xB];
+  // 0x280: 128a
+  pc = 0x28A;
+  Processor::Precompiled::tick(c8, 5);
+}
+
+// 0x282 - 0x28C
+static void
+block_282(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x282: 68fe
+  V[0x8] = 0xFE;
+  // 0x284: 630a
+  V[0x3] = 0x0A;
+  // 0x286: 8070
+  V[0x0] = V[0x7];
+  // 0x288: 80d5
+  V[0xF] = 1;
+  if ( V[0xD] > V[0x0] ) V[0xF] = 0;
+  V[0x0] -= V[0xD];
+  // 0x28A: 3f01
+  pc = ( V[0xF] == 0x01 ) ? 0x28E : 0x28C;
+  Processor::Precompiled::tick(c8, 5);
+}
+
+// 0x28A - 0x28C
+static void
+block_28A(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x28A: 3f01
+  pc = ( V[0xF] == 0x01 ) ? 0x28E : 0x28C;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x28C - 0x28E
+static void
+block_28C(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x28C: 12a2
+  pc = 0x2A2;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x28E - 0x294
+static void
+block_28E(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x28E: 6102
+  V[0x1] = 0x02;
+  // 0x290: 8015
+  V[0xF] = 1;
+  if ( V[0x1] > V[0x0] ) V[0xF] = 0;
+  V[0x0] -= V[0x1];
+  // 0x292: 3f01
+  pc = ( V[0xF] == 0x01 ) ? 0x296 : 0x294;
+  Processor::Precompiled::tick(c8, 3);
+}
+
+// 0x294 - 0x296
+static void
+block_294(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x294: 12ba
+  pc = 0x2BA;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x296 - 0x29A
+static void
+block_296(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x296: 8015
+  V[0xF] = 1;
+  if ( V[0x1] > V[0x0] ) V[0xF] = 0;
+  V[0x0] -= V[0x1];
+  // 0x298: 3f01
+  pc = ( V[0xF] == 0x01 ) ? 0x29C : 0x29A;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x29A - 0x29C
+static void
+block_29A(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x29A: 12c8
+  pc = 0x2C8;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x29C - 0x2A0
+static void
+block_29C(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x29C: 8015
+  V[0xF] = 1;
+  if ( V[0x1] > V[0x0] ) V[0xF] = 0;
+  V[0x0] -= V[0x1];
+  // 0x29E: 3f01
+  pc = ( V[0xF] == 0x01 ) ? 0x2A2 : 0x2A0;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2A0 - 0x2A2
+static void
+block_2A0(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2A0: 12c2
+  pc = 0x2C2;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x2A2 - 0x2A8
+static void
+block_2A2(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2A2: 6020
+  V[0x0] = 0x20;
+  // 0x2A4: f018
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x2A4;
+  Processor::Precompiled::execute(c8, 0xF018);
+  // 0x2A6: 22d4
+  stack[sp & 0xF] = 0x2A6;
+  ++sp;
+  pc = 0x2D4;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x2A8 - 0x2AC
+static void
+block_2A8(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2A8: 8e34
+  V[0xE] += V[0x3];
+  V[0xF] = 0;
+  if ( V[0x3] > (0xFF - V[0xE]) ) V[0xF] = 1;
+  // 0x2AA: 22d4
+  stack[sp & 0xF] = 0x2AA;
+  ++sp;
+  pc = 0x2D4;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2AC - 0x2B0
+static void
+block_2AC(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2AC: 663e
+  V[0x6] = 0x3E;
+  // 0x2AE: 3301
+  pc = ( V[0x3] == 0x01 ) ? 0x2B2 : 0x2B0;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2B0 - 0x2B6
+static void
+block_2B0(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2B0: 6603
+  V[0x6] = 0x03;
+  // 0x2B2: 68fe
+  V[0x8] = 0xFE;
+  // 0x2B4: 3301
+  pc = ( V[0x3] == 0x01 ) ? 0x2B8 : 0x2B6;
+  Processor::Precompiled::tick(c8, 3);
+}
+
+// 0x2B2 - 0x2B6
+static void
+block_2B2(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2B2: 68fe
+  V[0x8] = 0xFE;
+  // 0x2B4: 3301
+  pc = ( V[0x3] == 0x01 ) ? 0x2B8 : 0x2B6;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2B6 - 0x2BA
+static void
+block_2B6(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2B6: 6802
+  V[0x8] = 0x02;
+  // 0x2B8: 1216
+  pc = 0x216;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2B8 - 0x2BA
+static void
+block_2B8(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2B8: 1216
+  pc = 0x216;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x2BA - 0x2BE
+static void
+block_2BA(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2BA: 79ff
+  V[0x9] += 0xFF;
+  // 0x2BC: 49fe
+  pc = ( V[0x9] != 0xFE ) ? 0x2C0 : 0x2BE;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2BE - 0x2C2
+static void
+block_2BE(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2BE: 69ff
+  V[0x9] = 0xFF;
+  // 0x2C0: 12c8
+  pc = 0x2C8;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2C0 - 0x2C2
+static void
+block_2C0(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2C0: 12c8
+  pc = 0x2C8;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x2C2 - 0x2C6
+static void
+block_2C2(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2C2: 7901
+  V[0x9] += 0x01;
+  // 0x2C4: 4902
+  pc = ( V[0x9] != 0x02 ) ? 0x2C8 : 0x2C6;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2C6 - 0x2D0
+static void
+block_2C6(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2C6: 6901
+  V[0x9] = 0x01;
+  // 0x2C8: 6004
+  V[0x0] = 0x04;
+  // 0x2CA: f018
+  Processor::Precompiled::tick(c8, 2);
+  pc = 0x2CA;
+  Processor::Precompiled::execute(c8, 0xF018);
+  // 0x2CC: 7601
+  V[0x6] += 0x01;
+  // 0x2CE: 4640
+  pc = ( V[0x6] != 0x40 ) ? 0x2D2 : 0x2D0;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2C8 - 0x2D0
+static void
+block_2C8(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2C8: 6004
+  V[0x0] = 0x04;
+  // 0x2CA: f018
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x2CA;
+  Processor::Precompiled::execute(c8, 0xF018);
+  // 0x2CC: 7601
+  V[0x6] += 0x01;
+  // 0x2CE: 4640
+  pc = ( V[0x6] != 0x40 ) ? 0x2D2 : 0x2D0;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2D0 - 0x2D4
+static void
+block_2D0(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2D0: 76fe
+  V[0x6] += 0xFE;
+  // 0x2D2: 126c
+  pc = 0x26C;
+  Processor::Precompiled::tick(c8, 2);
+}
+
+// 0x2D2 - 0x2D4
+static void
+block_2D2(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2D2: 126c
+  pc = 0x26C;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+// 0x2D4 - 0x2D8
+static void
+block_2D4(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2D4: a2f2
+  I = 0x2F2;
+  // 0x2D6: fe33
+  Processor::Precompiled::tick(c8, 1);
+  pc = 0x2D6;
+  Processor::Precompiled::execute(c8, 0xFE33);
+}
+
+// 0x2D8 - 0x2E2
+static void
+block_2D8(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2D8: f265
+  for (int i = 0; i <= 0x2; ++i) V[i] = memory[(I + i) & 0xFFF];
+  I += 0x2 + 1;
+  // 0x2DA: f129
+  I = V[0x1] * 0x5;
+  // 0x2DC: 6414
+  V[0x4] = 0x14;
+  // 0x2DE: 6500
+  V[0x5] = 0x00;
+  // 0x2E0: d455
+  Processor::Precompiled::tick(c8, 4);
+  pc = 0x2E0;
+  Processor::Precompiled::execute(c8, 0xD455);
+}
+
+// 0x2E2 - 0x2E8
+static void
+block_2E2(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2E2: 7415
+  V[0x4] += 0x15;
+  // 0x2E4: f229
+  I = V[0x2] * 0x5;
+  // 0x2E6: d455
+  Processor::Precompiled::tick(c8, 2);
+  pc = 0x2E6;
+  Processor::Precompiled::execute(c8, 0xD455);
+}
+
+// 0x2E8 - 0x2EA
+static void
+block_2E8(Processor::Chip8 &c8)
+{
+  uint8_t  *V      = Processor::Precompiled::V(c8);
+  uint16_t &I      = Processor::Precompiled::I(c8);
+  uint16_t &pc     = Processor::Precompiled::pc(c8);
+  uint16_t *stack  = Processor::Precompiled::stack(c8);
+  uint16_t &sp     = Processor::Precompiled::sp(c8);
+  uint8_t  *memory = Processor::Precompiled::memory(c8);
+  (void)V; (void)I; (void)stack; (void)sp; (void)memory;
+
+  // 0x2E8: 00ee
+  --sp;
+  pc = stack[sp & 0xF];
+  pc += 2;
+  Processor::Precompiled::tick(c8, 1);
+}
+
+const Processor::PrecompiledBlock blocks[] = {
+  { 0x200, 0x20C, 6, block_200 },
+  { 0x20C, 0x20E, 1, block_20C },
+  { 0x20E, 0x212, 2, block_20E },
+  { 0x212, 0x21E, 6, block_212 },
+  { 0x216, 0x21E, 4, block_216 },
+  { 0x21A, 0x21E, 2, block_21A },
+  { 0x21E, 0x220, 1, block_21E },
+  { 0x220, 0x22A, 5, block_220 },
+  { 0x22A, 0x22E, 2, block_22A },
+  { 0x22E, 0x230, 1, block_22E },
+  { 0x230, 0x234, 2, block_230 },
+  { 0x234, 0x23A, 3, block_234 },
+  { 0x236, 0x23A, 2, block_236 },
+  { 0x23A, 0x242, 4, block_23A },
+  { 0x23C, 0x242, 3, block_23C },
+  { 0x242, 0x246, 2, block_242 },
+  { 0x246, 0x24C, 3, block_246 },
+  { 0x248, 0x24C, 2, block_248 },
+  { 0x24C, 0x254, 4, block_24C },
+  { 0x24E, 0x254, 3, block_24E },
+  { 0x254, 0x258, 2, block_254 },
+  { 0x258, 0x266, 7, block_258 },
+  { 0x266, 0x268, 1, block_266 },
+  { 0x268, 0x26A, 1, block_268 },
+  { 0x26A, 0x26C, 1, block_26A },
+  { 0x26C, 0x26E, 1, block_26C },
+  { 0x26E, 0x272, 2, block_26E },
+  { 0x270, 0x272, 1, block_270 },
+  { 0x272, 0x276, 2, block_272 },
+  { 0x274, 0x276, 1, block_274 },
+  { 0x276, 0x278, 1, block_276 },
+  { 0x278, 0x282, 5, block_278 },
+  { 0x282, 0x28C, 5, block_282 },
+  { 0x28A, 0x28C, 1, block_28A },
+  { 0x28C, 0x28E, 1, block_28C },
+  { 0x28E, 0x294, 3, block_28E },
+  { 0x294, 0x296, 1, block_294 },
+  { 0x296, 0x29A, 2, block_296 },
+  { 0x29A, 0x29C, 1, block_29A },
+  { 0x29C, 0x2A0, 2, block_29C },
+  { 0x2A0, 0x2A2, 1, block_2A0 },
+  { 0x2A2, 0x2A8, 3, block_2A2 },
+  { 0x2A8, 0x2AC, 2, block_2A8 },
+  { 0x2AC, 0x2B0, 2, block_2AC },
+  { 0x2B0, 0x2B6, 3, block_2B0 },
+  { 0x2B2, 0x2B6, 2, block_2B2 },
+  { 0x2B6, 0x2BA, 2, block_2B6 },
+  { 0x2B8, 0x2BA, 1, block_2B8 },
+  { 0x2BA, 0x2BE, 2, block_2BA },
+  { 0x2BE, 0x2C2, 2, block_2BE },
+  { 0x2C0, 0x2C2, 1, block_2C0 },
+  { 0x2C2, 0x2C6, 2, block_2C2 },
+  { 0x2C6, 0x2D0, 5, block_2C6 },
+  { 0x2C8, 0x2D0, 4, block_2C8 },
+  { 0x2D0, 0x2D4, 2, block_2D0 },
+  { 0x2D2, 0x2D4, 1, block_2D2 },
+  { 0x2D4, 0x2D8, 2, block_2D4 },
+  { 0x2D8, 0x2E2, 5, block_2D8 },
+  { 0x2E2, 0x2E8, 3, block_2E2 },
+  { 0x2E8, 0x2EA, 1, block_2E8 },
+};
+
+const Processor::PrecompiledRom rom = {
+  "pong", image, sizeof(image), blocks, sizeof(blocks) / sizeof(blocks[0])
+};
+
+struct Registration
+{
+  Registration() { Processor::Precompiled::add(&rom); }
+} registration;
+
+}
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "debug/profile.hpp"
+#include "debug/trace_ring.hpp"
+#include "processor/chip8.hpp"
+
+static_assert(Processor::OP_COUNT <= C8_PROFILE_OPERATIONS, "C8_PROFILE_OPERATIONS must cover every operation");
+
+static const char *classNames[16] = {
+  "0nnn", "1nnn", "2nnn", "3xkk", "4xkk", "5xy0", "6xkk", "7xkk",
+  "8xyN", "9xy0", "Annn", "Bnnn", "Cxkk", "Dxyn", "ExNN", "FxNN"
+};
+
+typedef std::vector< std::pair<uint64_t, std::string> > Ranking;
+
+// counts per handler name, several operations share a handler
+static Ranking
+handlers(const Debug::Profile &profile)
+{
+  std::map<std::string, uint64_t> counts;
+  for (int operation = 0; operation < Processor::OP_COUNT; ++operation)
+  {
+    if ( profile.operations[operation] != 0 )
+    {
+      counts[Debug::handlerName(operation)] += profile.operations[operation];
+    }
+  }
+
+  Ranking ranking;
+  for (std::map<std::string, uint64_t>::const_iterator i = counts.begin(); i != counts.end(); ++i)
+  {
+    ranking.push_back(std::make_pair(i->second, i->first));
+  }
+  std::sort(ranking.rbegin(), ranking.rend());
+  return ranking;
+}
+
+// addresses anything ran or waited at, where the most time went first
+static std::vector<uint16_t>
+hotSpots(const Debug::Profile &profile)
+{
+  std::vector<uint16_t> addresses;
+  for (int pc = 0; pc < C8_PROFILE_ADDRESSES; ++pc)
+  {
+    if ( profile.executed[pc] + profile.idle[pc] != 0 )
+    {
+      addresses.push_back(pc);
+    }
+  }
+
+  std::stable_sort(addresses.begin(), addresses.end(), [&profile](uint16_t a, uint16_t b) {
+    return profile.executed[a] + profile.idle[a] > profile.executed[b] + profile.idle[b];
+  });
+  return addresses;
+}
+
+Debug::Profile &
+Debug::profile()
+{
+  static Profile profile;
+  return profile;
+}
+
+Debug::CallGraph &
+Debug::callGraph()
+{
+  static CallGraph graph;
+  return graph;
+}
+
+void
+Debug::Profile::clear()
+{
+  memset(this, 0, sizeof(*this));
+}
+
+/*
+  The `top` addresses the most emulated time went to, then every handler
+  and opcode class by instructions executed
+*/
+void
+Debug::Profile::report(std::ostream &out, size_t top) const
+{
+  uint64_t executed = 0;
+  uint64_t idle = 0;
+  for (int pc = 0; pc < C8_PROFILE_ADDRESSES; ++pc)
+  {
+    executed += this->executed[pc];
+    idle += this->idle[pc];
+  }
+  double total = executed + idle > 0 ? (double)(executed + idle) : 1;
+
+  char line[160];
+  snprintf(line, sizeof(line), "%llu instructions executed, %llu skipped in idle loops\n",
+    (unsigned long long)executed, (unsigned long long)idle);
+  out << line;
+
+  out << "\naddress  opcode  handler                executed        idle    time\n";
+  std::vector<uint16_t> spots = hotSpots(*this);
+  for (size_t i = 0; i < spots.size() && i < top; ++i)
+  {
+    uint16_t pc = spots[i];
+    uint16_t opCode = this->opCodes[pc];
+    snprintf(line, sizeof(line), "0x%03X    %04X    %-20s %10llu  %10llu  %5.1f%%\n",
+      pc, opCode, this->executed[pc] != 0 ? handlerName(Processor::Chip8::decode(opCode).operation) : "-",
+      (unsigned long long)this->executed[pc], (unsigned long long)this->idle[pc],
+      100.0 * (this->executed[pc] + this->idle[pc]) / total);
+    out << line;
+  }
+
+  out << "\nhandler                  executed\n";
+  Ranking byHandler = handlers(*this);
+  for (size_t i = 0; i < byHandler.size(); ++i)
+  {
+    snprintf(line, sizeof(line), "%-20s %12llu  %5.1f%%\n", byHandler[i].second.c_str(),
+      (unsigned long long)byHandler[i].first, executed ? 100.0 * byHandler[i].first / executed : 0);
+    out << line;
+  }
+
+  out << "\nclass     executed\n";
+  Ranking byClass;
+  for (int i = 0; i < 16; ++i)
+  {
+    if ( this->classes[i] != 0 )
+    {
+      byClass.push_back(std::make_pair(this->classes[i], std::string(classNames[i])));
+    }
+  }
+  std::sort(byClass.rbegin(), byClass.rend());
+  for (size_t i = 0; i < byClass.size(); ++i)
+  {
+    snprintf(line, sizeof(line), "%-4s %12llu  %5.1f%%\n", byClass[i].second.c_str(),
+      (unsigned long long)byClass[i].first, executed ? 100.0 * byClass[i].first / executed : 0);
+    out << line;
+  }
+}
+
+/*
+  Everything counted as JSON, addresses in hot spot order
+*/
+bool
+Debug::Profile::write(const char *path) const
+{
+  FILE *file = fopen(path, "w");
+  if ( file == NULL )
+  {
+    return false;
+  }
+
+  fprintf(file, "{\"addresses\":[");
+  std::vector<uint16_t> spots = hotSpots(*this);
+  for (size_t i = 0; i < spots.size(); ++i)
+  {
+    uint16_t pc = spots[i];
+    fprintf(file, "%s\n  {\"pc\":%u,\"opcode\":%u,\"executed\":%llu,\"idle\":%llu}", i ? "," : "",
+      pc, this->opCodes[pc], (unsigned long long)this->executed[pc], (unsigned long long)this->idle[pc]);
+  }
+
+  fprintf(file, "\n],\"handlers\":{");
+  Ranking byHandler = handlers(*this);
+  for (size_t i = 0; i < byHandler.size(); ++i)
+  {
+    fprintf(file, "%s\"%s\":%llu", i ? "," : "", byHandler[i].second.c_str(), (unsigned long long)byHandler[i].first);
+  }
+
+  fprintf(file, "},\"classes\":{");
+  bool first = true;
+  for (int i = 0; i < 16; ++i)
+  {
+    if ( this->classes[i] != 0 )
+    {
+      fprintf(file, "%s\"%s\":%llu", first ? "" : ",", classNames[i], (unsigned long long)this->classes[i]);
+      first = false;
+    }
+  }
+  fprintf(file, "}}\n");
+
+  return fclose(file) == 0;
+}
+
+Debug::CallGraph::CallGraph()
+{
+  this->clear();
+}
+
+void
+Debug::CallGraph::clear()
+{
+  Node root;
+  memset(&root, 0, sizeof(root));
+  root.address = 0x200;
+  root.calls = 1;
+  this->nodes.assign(1, root);
+  this->current = 0;
+  this->overflow = 0;
+}
+
+/*
+  2nnn from the running subroutine, to the node for this chain of calls
+*/
+void
+Debug::CallGraph::call(uint16_t address)
+{
+  if ( this->nodes[this->current].depth == C8_PROFILE_MAX_DEPTH )
+  {
+    ++this->overflow;
+    return;
+  }
+
+  uint32_t child = this->nodes[this->current].firstChild;
+  while ( child != 0 && this->nodes[child].address != address )
+  {
+    child = this->nodes[child].nextSibling;
+  }
+
+  if ( child == 0 )
+  {
+    Node node;
+    memset(&node, 0, sizeof(node));
+    node.address = address;
+    node.parent = this->current;
+    node.nextSibling = this->nodes[this->current].firstChild;
+    node.depth = this->nodes[this->current].depth + 1;
+    child = this->nodes.size();
+    this->nodes.push_back(node);
+    this->nodes[this->current].firstChild = child;
+  }
+
+  ++this->nodes[child].calls;
+  this->current = child;
+}
+
+// frames from the outermost down, as flame graph tools expect them
+std::string
+Debug::CallGraph::path(uint32_t node) const
+{
+  std::string frames;
+  while ( node != 0 )
+  {
+    char frame[16];
+    snprintf(frame, sizeof(frame), ";sub_%03X", this->nodes[node].address);
+    frames = frame + frames;
+    node = this->nodes[node].parent;
+  }
+  return "main" + frames;
+}
+
+/*
+  Every subroutine by inclusive emulated time: calls, then instructions
+  executed inclusive and exclusive, then the share of emulated time (which
+  includes skipped idle loops) inclusive and exclusive. Recursive calls
+  count towards the inclusive time of the outermost one only.
+*/
+void
+Debug::CallGraph::report(std::ostream &out, size_t top) const
+{
+  // children always come after their parents
+  std::vector<uint64_t> instructions(this->nodes.size());
+  std::vector<uint64_t> time(this->nodes.size());
+  for (size_t node = this->nodes.size(); node-- > 0; )
+  {
+    instructions[node] += this->nodes[node].instructions;
+    time[node] += this->nodes[node].instructions + this->nodes[node].idle;
+    if ( node != 0 )
+    {
+      instructions[this->nodes[node].parent] += instructions[node];
+      time[this->nodes[node].parent] += time[node];
+    }
+  }
+
+  struct Subroutine
+  {
+    uint64_t calls;
+    uint64_t inclusive, exclusive;
+    uint64_t inclusiveTime, exclusiveTime;
+  };
+  std::map<uint32_t, Subroutine> subroutines;     // by address, the root as 0x1000
+  for (size_t node = 0; node < this->nodes.size(); ++node)
+  {
+    uint32_t address = node == 0 ? 0x1000 : this->nodes[node].address;
+    Subroutine &subroutine = subroutines[address];
+    subroutine.calls += this->nodes[node].calls;
+    subroutine.exclusive += this->nodes[node].instructions;
+    subroutine.exclusiveTime += this->nodes[node].instructions + this->nodes[node].idle;
+
+    bool recursive = false;
+    for (uint32_t up = this->nodes[node].parent; node != 0 && up != 0 && !recursive; up = this->nodes[up].parent)
+    {
+      recursive = this->nodes[up].address == address;
+    }
+    if ( !recursive )
+    {
+      subroutine.inclusive += instructions[node];
+      subroutine.inclusiveTime += time[node];
+    }
+  }
+
+  std::vector< std::pair<uint64_t, uint32_t> > order;
+  for (std::map<uint32_t, Subroutine>::const_iterator i = subroutines.begin(); i != subroutines.end(); ++i)
+  {
+    order.push_back(std::make_pair(i->second.inclusiveTime, i->first));
+  }
+  std::stable_sort(order.begin(), order.end(),
+    [](const std::pair<uint64_t, uint32_t> &a, const std::pair<uint64_t, uint32_t> &b) { return a.first > b.first; });
+
+  double total = time[0] > 0 ? (double)time[0] : 1;
+  char line[160];
+  out << "\nsubroutine      calls     inclusive     exclusive  incl. time  excl. time\n";
+  for (size_t i = 0; i < order.size() && i < top; ++i)
+  {
+    const Subroutine &subroutine = subroutines[order[i].second];
+    char name[16];
+    snprintf(name, sizeof(name), order[i].second == 0x1000 ? "main" : "sub_%03X", order[i].second);
+    snprintf(line, sizeof(line), "%-10s %10llu  %12llu  %12llu      %5.1f%%      %5.1f%%\n", name,
+      (unsigned long long)subroutine.calls, (unsigned long long)subroutine.inclusive,
+      (unsigned long long)subroutine.exclusive, 100.0 * subroutine.inclusiveTime / total,
+      100.0 * subroutine.exclusiveTime / total);
+    out << line;
+  }
+}
+
+/*
+  One line per chain of calls that took emulated time: the frames from
+  main down, separated by ';', and the exclusive time in instructions,
+  the input flamegraph.pl and similar tools take
+*/
+void
+Debug::CallGraph::folded(std::ostream &out) const
+{
+  for (size_t node = 0; node < this->nodes.size(); ++node)
+  {
+    uint64_t time = this->nodes[node].instructions + this->nodes[node].idle;
+    if ( time != 0 )
+    {
+      out << this->path(node) << ' ' << time << '\n';
+    }
+  }
+}
+
+bool
+Debug::CallGraph::write(const char *path) const
+{
+  std::ofstream file(path);
+  this->folded(file);
+  file.close();
+  return !file.fail();
+}
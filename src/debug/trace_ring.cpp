@@ -0,0 +1,121 @@
+#include <chrono>
+#include "debug/trace_ring.hpp"
+#include "processor/chip8.hpp"
+
+Debug::TraceRing::TraceRing(FILE *file)
+  : head(0), tail(0), stopping(false)
+{
+  this->file = file;
+  this->records = new TraceRecord[C8_TRACE_RING_SIZE];
+
+  TraceHeader header = { { 'C', '8', 'T', 'R' }, C8_TRACE_VERSION, sizeof(TraceRecord) };
+  fwrite(&header, sizeof(header), 1, this->file);
+
+  this->writer = std::thread(&TraceRing::drain, this);
+}
+
+/*
+  Stops the writer once everything recorded so far is on disk
+*/
+Debug::TraceRing::~TraceRing()
+{
+  this->stopping.store(true, std::memory_order_release);
+  this->writer.join();
+  fclose(this->file);
+  delete[] this->records;
+}
+
+Debug::TraceRing *
+Debug::TraceRing::open(const char *path)
+{
+  FILE *file = fopen(path, "wb");
+  if ( file == NULL )
+  {
+    return NULL;
+  }
+  return new TraceRing(file);
+}
+
+void
+Debug::TraceRing::drain()
+{
+  while (true)
+  {
+    bool last = this->stopping.load(std::memory_order_acquire);
+    uint64_t from = this->tail.load(std::memory_order_relaxed);
+    uint64_t to   = this->head.load(std::memory_order_acquire);
+
+    while ( from != to )
+    {
+      // up to the end of the ring in one write
+      uint64_t index = from & (C8_TRACE_RING_SIZE - 1);
+      uint64_t count = to - from;
+      if ( count > C8_TRACE_RING_SIZE - index )
+      {
+        count = C8_TRACE_RING_SIZE - index;
+      }
+      fwrite(&this->records[index], sizeof(TraceRecord), count, this->file);
+      from += count;
+      this->tail.store(from, std::memory_order_release);
+    }
+
+    if ( last )
+    {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+const char *
+Debug::handlerName(uint8_t operation)
+{
+  switch (operation)
+  {
+    case Processor::OP_CLS:
+    case Processor::OP_RET:              return "return_clear_screen";
+    case Processor::OP_JP_ADDR:          return "jp_addr";
+    case Processor::OP_CALL_ADDR:        return "call_addr";
+    case Processor::OP_SE_VX_BYTE:       return "se_vx_byte";
+    case Processor::OP_SNE_VX_BYTE:      return "sne_vx_byte";
+    case Processor::OP_LD_VX_BYTE:       return "ld_vx_byte";
+    case Processor::OP_ADD_VX_BYTE:      return "add_vx_byte";
+    case Processor::OP_LD_VX_VY:
+    case Processor::OP_OR_VX_VY:
+    case Processor::OP_AND_VX_VY:
+    case Processor::OP_XOR_VX_VY:
+    case Processor::OP_ADD_VX_VY:
+    case Processor::OP_SUB_VX_VY:
+    case Processor::OP_SHR_VX:
+    case Processor::OP_SUBN_VX_VY:
+    case Processor::OP_SHL_VX:           return "register_vx_vy_byte";
+    case Processor::OP_LD_I_ADDR:        return "ld_i_addr";
+    case Processor::OP_RND_VX_BYTE:      return "rnd_vx_byte";
+    case Processor::OP_DRW_VX_VY_NIBBLE: return "drw_vx_vy_nibble";
+    case Processor::OP_SKP_VX:
+    case Processor::OP_SKNP_VX:          return "ex_skip";
+    case Processor::OP_LD_VX_DT:         return "fx_ld_vx_dt";
+    case Processor::OP_LD_DT_VX:         return "fx_ld_dt_vx";
+    case Processor::OP_LD_ST_VX:         return "fx_ld_st_vx";
+    case Processor::OP_ADD_I_VX:         return "fx_add_i_vx";
+    case Processor::OP_LD_F_VX:          return "fx_ld_f_vx";
+    case Processor::OP_LD_B_VX:          return "fx_ld_b_vx";
+    case Processor::OP_LD_VX_I:          return "fx_ld_vx_i";
+    case Processor::OP_LD_VX_K:          return "fx_ld_vx_k";
+    default:                             return "unimplemented";
+  }
+}
+
+bool
+Debug::handlerLogged(uint8_t operation)
+{
+  switch (operation)
+  {
+    case Processor::OP_SE_VX_BYTE:
+    case Processor::OP_SNE_VX_BYTE:
+    case Processor::OP_LD_ST_VX:
+      return false;
+    default:
+      return true;
+  }
+}
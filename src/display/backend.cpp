@@ -0,0 +1,88 @@
+#include "display/backend.hpp"
+#include <cstring>
+#ifndef C8_NO_SDL
+#include "display/screen.hpp"
+#endif
+
+Display::FramebufferBackend::FramebufferBackend()
+{
+  this->frames = 0;
+  this->dirtyRows = 0;
+  for ( int i = 0; i < PIXEL_BUFFER_SIZE; ++i)
+  {
+    this->pixelBuffer[i] = 0;
+    this->frame[i] = 0;
+  }
+}
+
+void
+Display::FramebufferBackend::clearPixelBuffer()
+{
+  for ( int i = 0; i < PIXEL_BUFFER_SIZE; ++i)
+  {
+    this->pixelBuffer[i] = 0;
+  }
+  this->dirtyRows = 0xFFFFFFFF;
+}
+
+void
+Display::FramebufferBackend::pushToBuffer(int index, uint32_t pixel)
+{
+  this->pixelBuffer[index] = pixel;
+  this->dirtyRows |= 1U << (index / PIXEL_BUFFER_ROW);
+}
+
+void
+Display::FramebufferBackend::refresh()
+{
+  if ( this->dirtyRows == 0 )
+  {
+    return;
+  }
+  for ( int row = 0; row < PIXEL_BUFFER_SIZE / PIXEL_BUFFER_ROW; ++row)
+  {
+    if ( this->dirtyRows & (1U << row) )
+    {
+      memcpy(this->frame + row * PIXEL_BUFFER_ROW, this->pixelBuffer + row * PIXEL_BUFFER_ROW,
+        PIXEL_BUFFER_ROW * sizeof(uint32_t));
+    }
+  }
+  this->dirtyRows = 0;
+  ++this->frames;
+}
+
+/*
+  The last frame as text, one line per row, lit pixels as '#'
+*/
+void
+Display::FramebufferBackend::print(std::string &out) const
+{
+  for ( int row = 0; row < 32; ++row)
+  {
+    for ( int column = 0; column < 64; ++column)
+    {
+      out += (this->frame[row * 64 + column] & 0x00FFFFFF) ? '#' : '.';
+    }
+    out += '\n';
+  }
+}
+
+Display::Backend *
+Display::createBackend(const std::string &name)
+{
+#ifndef C8_NO_SDL
+  if ( name == "sdl" )
+  {
+    return new Screen();
+  }
+#endif
+  if ( name == "null" )
+  {
+    return new NullBackend();
+  }
+  if ( name == "framebuffer" )
+  {
+    return new FramebufferBackend();
+  }
+  return NULL;
+}
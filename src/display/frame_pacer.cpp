@@ -0,0 +1,121 @@
+#include "display/frame_pacer.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <time.h>
+
+Display::FramePacer::FramePacer(uint32_t hz, uint32_t slackMicroseconds)
+{
+  this->period = 1000000000LL / (hz > 0 ? hz : 1);
+  this->slack = (int64_t)slackMicroseconds * 1000;
+  this->deadline = 0;
+  this->frames = 0;
+  this->missed = 0;
+  this->mean = 0;
+  this->squares = 0;
+  this->worst = 0;
+}
+
+int64_t
+Display::FramePacer::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+  steady_clock is CLOCK_MONOTONIC on Linux, where an absolute sleep on it
+  can't drift the way a relative one would
+*/
+void
+Display::FramePacer::sleepUntil(int64_t time)
+{
+#ifdef __linux__
+  struct timespec until;
+  until.tv_sec = time / 1000000000LL;
+  until.tv_nsec = time % 1000000000LL;
+  // interrupted by a signal, go back to sleep; on any other error the caller spins the rest of the way
+  while ( clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR )
+  {
+  }
+#else
+  std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(time)));
+#endif
+}
+
+/*
+  Returns at the start of the next frame
+*/
+void
+Display::FramePacer::wait()
+{
+  int64_t current = FramePacer::now();
+  if ( this->deadline == 0 )
+  {
+    this->deadline = current;
+  }
+  this->deadline += this->period;
+
+  // too far behind to catch up, start counting from now instead of rushing frames out
+  if ( current - this->deadline > this->period )
+  {
+    ++this->missed;
+    this->deadline = current;
+    return;
+  }
+
+  if ( this->deadline - current > this->slack )
+  {
+    FramePacer::sleepUntil(this->deadline - this->slack);
+  }
+  do
+  {
+    current = FramePacer::now();
+  }
+  while ( current < this->deadline );
+
+  int64_t late = current - this->deadline;
+  ++this->frames;
+  double delta = late - this->mean;
+  this->mean += delta / this->frames;
+  this->squares += delta * (late - this->mean);
+  if ( late > this->worst )
+  {
+    this->worst = late;
+  }
+}
+
+/*
+  The next wait() starts counting frames afresh, after a deliberate pause
+  that shouldn't count as missed frames
+*/
+void
+Display::FramePacer::restart()
+{
+  this->deadline = 0;
+}
+
+Display::PacingStats
+Display::FramePacer::stats() const
+{
+  PacingStats stats;
+  stats.frames = this->frames;
+  stats.missed = this->missed;
+  stats.mean = this->mean;
+  stats.deviation = this->frames > 1 ? sqrt(this->squares / (this->frames - 1)) : 0;
+  stats.worst = this->worst;
+  return stats;
+}
+
+void
+Display::FramePacer::report(std::string &out) const
+{
+  PacingStats stats = this->stats();
+  char line[160];
+  snprintf(line, sizeof(line), "%llu frames, %llu missed, jitter mean %.1f us, stddev %.1f us, worst %.1f us\n",
+    (unsigned long long)stats.frames, (unsigned long long)stats.missed,
+    stats.mean / 1000, stats.deviation / 1000, stats.worst / 1000.0);
+  out += line;
+}
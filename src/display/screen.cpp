@@ -1,24 +1,5 @@
 #include "display/screen.hpp"
 
-uint8_t keymap[16] = {
-    SDLK_x,
-    SDLK_1,
-    SDLK_2,
-    SDLK_3,
-    SDLK_q,
-    SDLK_w,
-    SDLK_e,
-    SDLK_a,
-    SDLK_s,
-    SDLK_d,
-    SDLK_z,
-    SDLK_c,
-    SDLK_4,
-    SDLK_r,
-    SDLK_f,
-    SDLK_v,
-};
-
 Display::Screen::Screen()
 {
 
@@ -46,6 +27,12 @@ Display::Screen::Screen()
     SDL_PIXELFORMAT_ARGB8888,
     SDL_TEXTUREACCESS_STREAMING,
     64, 32);
+
+  this->dirtyRows = 0;
+  this->exposed = false;
+  this->pausing = false;
+  this->closing = false;
+  this->clearPixelBuffer();
 }
 
 Display::Screen::~Screen()
@@ -60,12 +47,28 @@ Display::Screen::clearPixelBuffer()
   {
     this->pixelBuffer[i] = 0;
   }
+  this->dirtyRows = 0xFFFFFFFF;
 }
 
 void
 Display::Screen::pushToBuffer(int index, uint32_t pixel)
 {
   this->pixelBuffer[index] = pixel;
+  this->dirtyRows |= 1U << (index / PIXEL_BUFFER_ROW);
+}
+
+void
+Display::Screen::handle(const SDL_Event &event)
+{
+  if (event.type == SDL_QUIT) this->closing = true;
+  if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED) this->exposed = true;
+  if (event.type == SDL_KEYDOWN && !event.key.repeat && event.key.keysym.sym == SDLK_p) this->pausing = !this->pausing;
+
+  // keypad keys, stamped as they are handled, right after the event queue woke us up
+  if ((event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) && !event.key.repeat && this->keypad != NULL)
+  {
+    this->keypad->press(event.key.keysym.sym, event.type == SDL_KEYDOWN, Input::clock());
+  }
 }
 
 void
@@ -73,16 +76,52 @@ Display::Screen::inputManager()
 {
   while(SDL_PollEvent(&(this->e)))
   {
-    if (e.type == SDL_QUIT) exit(0);
+    this->handle(this->e);
   }
 }
 
+/*
+  Sleeps in SDL until an event comes in, then handles everything queued
+*/
+bool
+Display::Screen::waitForInput(uint32_t milliseconds)
+{
+  if (!SDL_WaitEventTimeout(&(this->e), milliseconds))
+  {
+    return false;
+  }
+  this->handle(this->e);
+  this->inputManager();
+  return true;
+}
+
 void
 Display::Screen::refresh()
 {
+  if (this->dirtyRows == 0 && !this->exposed)
+  {
+    return;
+  }
 
-  // Update SDL texture
-  SDL_UpdateTexture(this->sdlTexture, NULL, this->pixelBuffer, 64 * sizeof(Uint32));
+  // Update only the runs of rows that changed
+  int row = 0;
+  while (row < 32)
+  {
+    if (!(this->dirtyRows & (1U << row)))
+    {
+      ++row;
+      continue;
+    }
+    int first = row;
+    while (row < 32 && (this->dirtyRows & (1U << row)))
+    {
+      ++row;
+    }
+    SDL_Rect rect = { 0, first, 64, row - first };
+    SDL_UpdateTexture(this->sdlTexture, &rect, this->pixelBuffer + first * 64, 64 * sizeof(Uint32));
+  }
+  this->dirtyRows = 0;
+  this->exposed = false;
 
   // Clear screen and render
   SDL_RenderClear(this->renderer);
@@ -0,0 +1,258 @@
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "host/emulator.hpp"
+
+using namespace std;
+
+/*
+  Converts the rows that changed since the last frame and hands them to the
+  display. Frames that changed nothing never reach it.
+*/
+void
+Host::present(const uint64_t *rows, uint32_t changed, Display::Backend *window)
+{
+  if (changed == 0)
+  {
+    return;
+  }
+
+  for ( int y = 0; y < C8_GFX_WIDTH; ++y)
+  {
+    if (!(changed & (1U << y)))
+    {
+      continue;
+    }
+    for ( int x = 0; x < C8_GFX_LENGTH; ++x)
+    {
+      uint8_t pixel = (rows[y] >> (C8_GFX_LENGTH - 1 - x)) & 1;
+      window->pushToBuffer(y * C8_GFX_LENGTH + x, ((0x00FFFFFF * pixel) | 0xFF000000));
+    }
+  }
+  window->refresh();
+}
+
+/*
+  Presents a frame published by the processor thread, `shown` is what the
+  window shows so far
+*/
+void
+Host::present(const Display::Frame &frame, Display::Frame &shown, Display::Backend *window)
+{
+  uint32_t changed = 0;
+  for ( int y = 0; y < C8_GFX_WIDTH; ++y)
+  {
+    if (frame.rows[y] != shown.rows[y])
+    {
+      changed |= 1U << y;
+      shown.rows[y] = frame.rows[y];
+    }
+  }
+  present(shown.rows, changed, window);
+}
+
+static volatile sig_atomic_t stopping = 0;
+
+void
+Host::requestStop(int)
+{
+  stopping = 1;
+}
+
+bool
+Host::stopRequested()
+{
+  return stopping != 0;
+}
+
+#ifdef C8_PROFILE
+const char *Host::profileFile = "c8-profile.json";
+const char *Host::callGraphFile = "c8-profile.folded";
+static volatile sig_atomic_t profileRequested = 0;
+
+void
+Host::requestProfile(int)
+{
+  profileRequested = 1;
+}
+
+void
+Host::dumpProfile()
+{
+  Debug::profile().report(cerr, 20);
+  Debug::callGraph().report(cerr, 20);
+  if (!Debug::profile().write(profileFile))
+  {
+    cerr << "Can't write profile " << profileFile << endl;
+  }
+  if (!Debug::callGraph().write(callGraphFile))
+  {
+    cerr << "Can't write call graph " << callGraphFile << endl;
+  }
+}
+#endif
+
+uint64_t
+Host::inputEvents(Signals *signals)
+{
+  std::lock_guard<std::mutex> guard(signals->lock);
+  return signals->events;
+}
+
+void
+Host::notifyInput(Signals *signals)
+{
+  {
+    std::lock_guard<std::mutex> guard(signals->lock);
+    ++signals->events;
+  }
+  signals->input.notify_one();
+}
+
+/*
+  Sleeps until input arrives after the `seen`th event
+*/
+void
+Host::waitForInput(Signals *signals, uint64_t seen)
+{
+  std::unique_lock<std::mutex> guard(signals->lock);
+  signals->blocked.store(true, std::memory_order_relaxed);
+  while (signals->events == seen)
+  {
+    signals->input.wait(guard);
+  }
+  signals->blocked.store(false, std::memory_order_relaxed);
+}
+
+/*
+  Runs the processor until it halts, has executed `cycles` instructions or
+  `running` is cleared, one frame's worth of instructions at a time. With a
+  pacer, a frame starts every 1/60 s, and nothing runs at all while the
+  program can only wait for input or the window is paused: emulated time
+  stands still until input arrives. Finished frames are published to
+  `frames` when the window renders on another thread, and presented right
+  here otherwise.
+
+  Key events from the last frame of wall time are applied at the same point
+  of this frame's instructions, so input keeps its timing within a frame.
+*/
+void
+Host::emulate(Processor::Chip8 *c8, unsigned long cycles, Display::Backend *window, Input::Keypad *keypad,
+              Display::TripleBuffer<Display::Frame> *frames, Signals *signals, Display::FramePacer *pacer)
+{
+  const int64_t period = 1000000000LL / C8_TIMER_HZ;
+  int64_t lastFrame = 0;      // when the previous frame started, 0 to apply input right away
+  std::vector<Input::KeyEvent> input;
+  Input::KeyEvent event;
+  unsigned long executed = 0;
+  while ((cycles == 0 || executed < cycles) && !c8->halted && signals->running.load(std::memory_order_relaxed) &&
+         !stopRequested())
+  {
+    // bounded runs keep going, or a program waiting for a key would never reach the end
+    if (pacer != NULL && cycles == 0)
+    {
+      uint64_t seen = inputEvents(signals);
+      bool blocked = signals->paused.load(std::memory_order_relaxed);
+      if (!blocked && c8->waitingForInput())
+      {
+        // what woke us up, applied right away as no emulated time passes while waiting
+        while (keypad->next(event))
+        {
+          c8->press(event.key, event.down);
+        }
+        blocked = c8->waitingForInput();
+      }
+      if (blocked)
+      {
+        waitForInput(signals, seen);
+        pacer->restart();
+        lastFrame = 0;
+        continue;
+      }
+    }
+
+    uint32_t budget = c8->getInstructionsPerFrame();
+    if (cycles != 0 && cycles - executed < budget)
+    {
+      budget = cycles - executed;
+    }
+
+    int64_t frameStart = Input::clock();
+    input.clear();
+    while (keypad->next(event))
+    {
+      input.push_back(event);
+    }
+
+    // run() stops early on draws, the frame is shown once it is complete
+    uint32_t done = 0;
+    size_t applied = 0;
+    while (done < budget && !c8->halted)
+    {
+      uint32_t until = budget;
+      for (; applied < input.size(); ++applied)
+      {
+        int64_t since = lastFrame != 0 ? input[applied].time - lastFrame : 0;
+        uint32_t at = since <= 0 ? 0 : (uint32_t)std::min<int64_t>(since * budget / period, budget - 1);
+        if (at > done)
+        {
+          until = at;
+          break;
+        }
+        c8->press(input[applied].key, input[applied].down);
+      }
+
+      uint32_t ran = c8->run(until - done);
+      done += ran;
+      c8->drawFlag = false;
+    }
+    for (; applied < input.size(); ++applied)
+    {
+      c8->press(input[applied].key, input[applied].down);
+    }
+    executed += done;
+    lastFrame = frameStart;
+
+    if (c8->beepFlag)
+    {
+      c8->beepFlag = false;
+      cout << '\7';
+    }
+
+    //
+    // drawing
+    //
+    if (frames == NULL)
+    {
+      present(c8->graphicsBuffer, c8->dirtyRows, window);
+
+      // pull events (key presses), once a frame
+      window->inputManager();
+      if (window->closed())
+      {
+        signals->running.store(false, std::memory_order_relaxed);
+      }
+    }
+    else if (c8->dirtyRows != 0)
+    {
+      memcpy(frames->back().rows, c8->graphicsBuffer, sizeof(c8->graphicsBuffer));
+      frames->publish();
+    }
+    c8->dirtyRows = 0;
+
+#ifdef C8_PROFILE
+    if (profileRequested)
+    {
+      profileRequested = 0;
+      dumpProfile();
+    }
+#endif
+
+    if (pacer != NULL)
+    {
+      pacer->wait();
+    }
+  }
+  signals->running.store(false, std::memory_order_release);
+}
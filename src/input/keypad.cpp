@@ -0,0 +1,101 @@
+#include <cctype>
+#include "input/keypad.hpp"
+
+Input::Keypad::Keypad()
+  : head(0), tail(0)
+{
+  this->setLayout(C8_DEFAULT_KEY_LAYOUT);
+}
+
+/*
+  `keys` names the host key for each CHIP-8 key from 0 to F, one character
+  each (SDL key codes of letters and digits are their lower case ASCII).
+  Leaves the layout alone and returns false unless there are exactly 16
+  different keys.
+*/
+bool
+Input::Keypad::setLayout(const std::string &keys)
+{
+  if ( keys.size() != 16 )
+  {
+    return false;
+  }
+
+  int32_t layout[16];
+  for (int i = 0; i < 16; ++i)
+  {
+    layout[i] = tolower((unsigned char)keys[i]);
+    for (int j = 0; j < i; ++j)
+    {
+      if ( layout[j] == layout[i] )
+      {
+        return false;
+      }
+    }
+  }
+
+  for (int i = 0; i < 16; ++i)
+  {
+    this->layout[i] = layout[i];
+  }
+  return true;
+}
+
+/*
+  The CHIP-8 key a host key is mapped to, -1 if none
+*/
+int
+Input::Keypad::key(int32_t hostKey) const
+{
+  for (int i = 0; i < 16; ++i)
+  {
+    if ( this->layout[i] == hostKey )
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*
+  Queues a host key event, false if the key isn't mapped or the ring is full
+*/
+bool
+Input::Keypad::press(int32_t hostKey, bool down, int64_t time)
+{
+  int key = this->key(hostKey);
+  if ( key < 0 )
+  {
+    return false;
+  }
+
+  uint32_t at = this->head.load(std::memory_order_relaxed);
+  if ( at - this->tail.load(std::memory_order_acquire) >= C8_KEY_QUEUE_SIZE )
+  {
+    return false;
+  }
+
+  KeyEvent &event = this->events[at & (C8_KEY_QUEUE_SIZE - 1)];
+  event.time = time;
+  event.key  = key;
+  event.down = down;
+  this->head.store(at + 1, std::memory_order_release);
+  return true;
+}
+
+/*
+  Takes the oldest queued event, false if there is none
+*/
+bool
+Input::Keypad::next(KeyEvent &event)
+{
+  uint32_t at = this->tail.load(std::memory_order_relaxed);
+  if ( at == this->head.load(std::memory_order_acquire) )
+  {
+    return false;
+  }
+
+  event = this->events[at & (C8_KEY_QUEUE_SIZE - 1)];
+  this->tail.store(at + 1, std::memory_order_release);
+  return true;
+}
@@ -1,15 +1,17 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
-#include "display/screen.hpp"
-#include "processor/chip8.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include "host/emulator.hpp"
 
 using namespace std;
 
 #define LD(byte) c8->memory[512 + offset] = byte; offset++;
 
 void
-chip8Debug(Processor::Chip8 *c8, Display::Screen *window)
+chip8Debug(Processor::Chip8 *c8)
 {
   for (int i = 0; i < 4096; ++i)
   {
@@ -44,76 +46,260 @@ chip8Debug(Processor::Chip8 *c8, Display::Screen *window)
   // jp_addr
     LD(0x12); LD(0x0A);
 
+  // no engine may keep running code translated from the ROM
+  c8->invalidateCode(0, 4096);
 }
 
 int
 main( const int argc, const char **argv )
 {
-  if (argc < 2) {
-    cout << "Usage: c8 <ROM file>" << endl;
+  const char *romFile = NULL;
+  const char *traceFile = NULL;
+#ifdef C8_NO_SDL
+  std::string display = "null";
+#else
+  std::string display = "sdl";
+#endif
+  unsigned long cycles = 0;   // run forever
+  unsigned long instructionsPerFrame = C8_INSTRUCTIONS_PER_FRAME;
+  unsigned long slack = 500;  // microseconds of each frame wait spent spinning
+  bool pacingStats = false;
+  Input::Keypad keypad;
+  bool debug = false;
+  Processor::Engine engine = Processor::ENGINE_DISPATCH;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--engine=threaded")
+    {
+      engine = Processor::ENGINE_THREADED;
+    }
+    else if (arg == "--engine=block")
+    {
+      engine = Processor::ENGINE_BLOCK;
+    }
+    else if (arg == "--engine=jit")
+    {
+      engine = Processor::ENGINE_JIT;
+    }
+    else if (arg == "--engine=precompiled")
+    {
+      engine = Processor::ENGINE_PRECOMPILED;
+    }
+    else if (arg == "--engine=dispatch")
+    {
+      engine = Processor::ENGINE_DISPATCH;
+    }
+    else if (arg == "--trace")
+    {
+#if C8_TRACE_LEVEL > C8_TRACE_OFF
+      Debug::traceEnabled() = true;
+#else
+      cout << "Tracing is compiled out of this build, rebuild with TRACE=opcodes or TRACE=state" << endl;
+#endif
+    }
+    else if (arg.compare(0, 13, "--trace-file=") == 0)
+    {
+      traceFile = argv[i] + 13;
+    }
+    else if (arg.compare(0, 10, "--profile=") == 0)
+    {
+#ifdef C8_PROFILE
+      Host::profileFile = argv[i] + 10;
+#else
+      cout << "Profiling is compiled out of this build, rebuild with PROFILE=on" << endl;
+#endif
+    }
+    else if (arg.compare(0, 13, "--call-graph=") == 0)
+    {
+#ifdef C8_PROFILE
+      Host::callGraphFile = argv[i] + 13;
+#else
+      cout << "Profiling is compiled out of this build, rebuild with PROFILE=on" << endl;
+#endif
+    }
+    else if (arg == "--headless")
+    {
+      display = "null";
+    }
+    else if (arg.compare(0, 10, "--display=") == 0)
+    {
+      display = arg.substr(10);
+    }
+    else if (arg.compare(0, 9, "--cycles=") == 0)
+    {
+      cycles = strtoul(argv[i] + 9, NULL, 10);
+    }
+    else if (arg.compare(0, 6, "--ipf=") == 0)
+    {
+      instructionsPerFrame = strtoul(argv[i] + 6, NULL, 10);
+    }
+    else if (arg.compare(0, 8, "--slack=") == 0)
+    {
+      slack = strtoul(argv[i] + 8, NULL, 10);
+    }
+    else if (arg == "--pacing-stats")
+    {
+      pacingStats = true;
+    }
+    else if (arg.compare(0, 9, "--keymap=") == 0)
+    {
+      if (!keypad.setLayout(arg.substr(9)))
+      {
+        cout << "A keymap names 16 different keys, for CHIP-8 keys 0 to F" << endl;
+        return 1;
+      }
+    }
+    else if (romFile == NULL)
+    {
+      romFile = argv[i];
+    }
+    else
+    {
+      debug = true;
+    }
+  }
+
+  if (romFile == NULL) {
+    cout << "Usage: c8 [--engine=dispatch|threaded|block|jit|precompiled] [--trace] [--trace-file=<file>]"
+         << " [--profile=<file>] [--call-graph=<file>]"
+         << " [--headless | --display=sdl|null|framebuffer] [--cycles=<n>] [--ipf=<n>]"
+         << " [--slack=<us>] [--pacing-stats] [--keymap=<16 keys>] <ROM file>" << endl;
     return 1;
   }
 
-  Display::Screen *window = new Display::Screen();
-  Processor::Chip8 *C8 = new Processor::Chip8(argv[1]);
+  Display::Backend *window = Display::createBackend(display);
+  if (window == NULL)
+  {
+    cout << "Unknown or unavailable display: " << display << endl;
+    return 1;
+  }
+  window->attach(&keypad);
+  Processor::Chip8 *C8 = new Processor::Chip8(romFile);
 
   C8->initialize();
 
-  if (argc == 3)
+  // before choosing the engine, so the precompiled engine looks up the debug program and not the ROM
+  if (debug)
   {
-    chip8Debug(C8, window);
+    chip8Debug(C8);
     C8->debugMemory();
+  }
 
-    while (true)
-    {
-      C8->cycle();
-      window->inputManager();
+  C8->setEngine(engine);
+  C8->setInstructionsPerFrame(instructionsPerFrame);
 
-      if (C8->drawFlag)
-      {
-        C8->drawFlag = false;
-        for ( int i = 0; i < 2048; ++i)
-        {
-          uint8_t pixel = C8->graphicsBuffer[i];
-          window->pushToBuffer(i, ((0x00FFFFFF * pixel) | 0xFF000000));
-        }
+  if (traceFile != NULL && !C8->recordTrace(traceFile))
+  {
+    cout << "Can't write trace file " << traceFile << endl;
+    return 1;
+  }
 
-        window->refresh();
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-      }
-    }
+  // rather than dying with the profile and the end of the trace unwritten
+  signal(SIGINT, Host::requestStop);
+  signal(SIGTERM, Host::requestStop);
+#ifdef C8_PROFILE
+  signal(SIGUSR1, Host::requestProfile);
+#endif
 
-    delete(C8);
-    delete(window);
-    return 0;
+  Host::Signals signals;
+  signals.running = true;
+  signals.paused = false;
+  signals.blocked = false;
+  signals.events = 0;
+  if (!window->interactive())
+  {
+    Host::emulate(C8, cycles, window, &keypad, NULL, &signals, NULL);
   }
-
-  while (true)
+  else
   {
-    C8->cycle();
-
-    // pull events (key presses)
-    window->inputManager();
+    // SDL wants its window driven from the main thread, so the processor gets its own
+    Display::TripleBuffer<Display::Frame> frames;
+    Display::FramePacer pacer(C8_TIMER_HZ, slack);
+    std::thread processor(Host::emulate, C8, cycles, window, &keypad, &frames, &signals, &pacer);
 
-    //
-    // drawing
-    //
-    if (C8->drawFlag)
+    // sleep in the event queue between refreshes, and for as long as the processor waits for input
+    const std::chrono::microseconds period(1000000 / C8_TIMER_HZ);
+    std::chrono::steady_clock::time_point refresh = std::chrono::steady_clock::now();
+    Display::Frame shown;
+    memset(&shown, 0, sizeof(shown));
+    while (signals.running.load(std::memory_order_acquire))
     {
-      C8->drawFlag = false;
-      //window->clearPixelBuffer();
-      for ( int i = 0; i < 2048; ++i)
+      // on SIGINT or SIGTERM, in case the processor sleeps waiting for input
+      if (Host::stopRequested())
       {
-        uint8_t pixel = C8->graphicsBuffer[i];
-        window->pushToBuffer(i, ((0x00FFFFFF * pixel) | 0xFF000000));
+        Host::notifyInput(&signals);
       }
 
+      if (frames.update())
+      {
+        Host::present(frames.front(), shown, window);
+      }
+      // repaints an exposed window even when nothing changed
       window->refresh();
-      std::this_thread::sleep_for(std::chrono::milliseconds(75));
+
+      refresh += period;
+      while (true)
+      {
+        bool blocked = signals.blocked.load(std::memory_order_relaxed);
+        std::chrono::steady_clock::duration left = refresh - std::chrono::steady_clock::now();
+        if (!blocked && left <= std::chrono::steady_clock::duration::zero())
+        {
+          break;
+        }
+        uint32_t timeout = blocked ? 250 : std::chrono::duration_cast<std::chrono::milliseconds>(left).count() + 1;
+        if (window->waitForInput(timeout))
+        {
+          // the processor finishes its frame and everything shuts down below
+          if (window->closed())
+          {
+            signals.running.store(false, std::memory_order_relaxed);
+          }
+          signals.paused.store(window->paused(), std::memory_order_relaxed);
+          Host::notifyInput(&signals);
+        }
+        else if (blocked)
+        {
+          break;
+        }
+      }
+      // rather than rushing frames out after falling behind
+      if (std::chrono::steady_clock::now() - refresh > period)
+      {
+        refresh = std::chrono::steady_clock::now();
+      }
     }
+    processor.join();
 
+    if (pacingStats)
+    {
+      std::string report;
+      pacer.report(report);
+      cerr << report;
+    }
+
+    if (frames.update())
+    {
+      Host::present(frames.front(), shown, window);
+    }
   }
+
+#ifdef C8_PROFILE
+  Host::dumpProfile();
+#endif
+
+  // headless runs report the final frame
+  Display::FramebufferBackend *framebuffer = dynamic_cast<Display::FramebufferBackend *>(window);
+  if (framebuffer != NULL)
+  {
+    std::string frame;
+    framebuffer->print(frame);
+    cout << frame;
+  }
+
+  int status = C8->halted ? 1 : 0;
   delete(C8);
   delete(window);
-  return 0;
+  return status;
 }
\ No newline at end of file
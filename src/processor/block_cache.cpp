@@ -0,0 +1,154 @@
+#include "processor/block_cache.hpp"
+
+/*
+  Operations that can change the program counter (or need the host to redraw
+  or deliver a key) close the block they are in.
+*/
+static bool
+endsBlock(uint8_t operation)
+{
+  switch (operation)
+  {
+    case Processor::OP_UNIMPLEMENTED:
+    case Processor::OP_CLS:
+    case Processor::OP_RET:
+    case Processor::OP_JP_ADDR:
+    case Processor::OP_CALL_ADDR:
+    case Processor::OP_SE_VX_BYTE:
+    case Processor::OP_SNE_VX_BYTE:
+    case Processor::OP_DRW_VX_VY_NIBBLE:
+    case Processor::OP_SKP_VX:
+    case Processor::OP_SKNP_VX:
+    case Processor::OP_LD_VX_K:
+      return true;
+    default:
+      return false;
+  }
+}
+
+Processor::BlockCache::BlockCache()
+{
+  this->generation = 0;
+  this->flush();
+}
+
+void
+Processor::BlockCache::flush()
+{
+  this->blocks.clear();
+  this->ops.clear();
+  this->stale = 0;
+  ++this->generation;
+
+  for (int i = 0; i < 4096; ++i)
+  {
+    this->blockAt[i] = -1;
+    this->coverage[i] = 0;
+  }
+}
+
+const Processor::Block *
+Processor::BlockCache::lookup(uint16_t address) const
+{
+  if ( address >= 4096 || this->blockAt[address] < 0 )
+  {
+    return NULL;
+  }
+  return &this->blocks[this->blockAt[address]];
+}
+
+/*
+  Decodes the block starting at `address`. Only called between blocks, as
+  growing the pools may move blocks handed out earlier.
+*/
+const Processor::Block *
+Processor::BlockCache::build(uint16_t address, const uint8_t *memory, const Chip8::Instruction *decodeTable)
+{
+  if ( this->stale > C8_BLOCK_MAX_STALE )
+  {
+    this->flush();
+  }
+
+  Block block;
+  block.start  = address;
+  block.first  = this->ops.size();
+  block.length = 0;
+  block.valid  = true;
+
+  // the instruction at 0xFFF wraps around to 0x000, it is left to the interpreter
+  uint16_t pc = address;
+  while ( pc + 1 < 4096 && block.length < C8_BLOCK_MAX_OPS )
+  {
+    const Chip8::Instruction *op = &decodeTable[memory[pc] << 8 | memory[pc + 1]];
+    this->ops.push_back(op);
+    ++block.length;
+    pc += 2;
+
+    if ( endsBlock(op->operation) )
+    {
+      break;
+    }
+  }
+  block.end = pc;
+
+  for (uint16_t i = block.start; i < block.end; ++i)
+  {
+    ++this->coverage[i];
+  }
+
+  this->blockAt[address] = this->blocks.size();
+  this->blocks.push_back(block);
+  return &this->blocks.back();
+}
+
+const Processor::Chip8::Instruction * const *
+Processor::BlockCache::microOps(const Block *block) const
+{
+  return &this->ops[block->first];
+}
+
+/*
+  Drops every block that overlaps memory written at [address, address + length)
+*/
+void
+Processor::BlockCache::invalidate(uint16_t address, uint16_t length)
+{
+  uint32_t end = address + length;
+  if ( end > 4096 )
+  {
+    end = 4096;
+  }
+
+  bool covered = false;
+  for (uint32_t i = address; i < end; ++i)
+  {
+    if ( this->coverage[i] )
+    {
+      covered = true;
+      break;
+    }
+  }
+
+  if ( !covered )
+  {
+    return;
+  }
+
+  for (size_t b = 0; b < this->blocks.size(); ++b)
+  {
+    Block &block = this->blocks[b];
+    if ( !block.valid || block.end <= address || block.start >= end )
+    {
+      continue;
+    }
+
+    block.valid = false;
+    this->blockAt[block.start] = -1;
+    for (uint16_t i = block.start; i < block.end; ++i)
+    {
+      --this->coverage[i];
+    }
+    ++this->stale;
+  }
+  ++this->generation;
+}
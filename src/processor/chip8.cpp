@@ -1,25 +1,47 @@
 #include "processor/chip8.hpp"
 #include "processor/fontset.hpp"
+#include "processor/block_cache.hpp"
+#include "processor/jit.hpp"
+#include "processor/precompiled.hpp"
+
+Processor::Chip8::Instruction Processor::Chip8::decodeTable[C8_OPCODE_COUNT];
+std::once_flag Processor::Chip8::decodeTableBuilt;
 
 Processor::Chip8::Chip8(const char *file_path)
 {
   this->filename = file_path;
-  //this->drawFlag = false;
+  this->drawFlag = false;
+  this->beepFlag = false;
+  this->halted = false;
+  this->keyWait = 0;
+  this->keyHeld = C8_NO_KEY;
+  this->engine = ENGINE_DISPATCH;
+  this->blockCache = NULL;
+  this->jit = NULL;
+  this->precompiled = NULL;
+  this->traceRing = NULL;
+  this->idling = false;
+  this->idleCycles = 0;
+  this->indexRegister = 0;
+  this->opCode = 0;
 
   // our program is loaded at "address" 0x200
   this->programCounter = C8_MEMORY_OFFSET_HEX;
   this->sp = 0;
-  this->delayTimer = 0;
-  this->soundTimer = 0;
+  this->clock = 0;
+  this->instructionsPerFrame = C8_INSTRUCTIONS_PER_FRAME;
+  this->delayExpires = 0;
+  this->soundExpires = 0;
 
   for (int i = 0; i < 4096; ++i)
   {
     this->memory[i] = 0;
   }
 
-  for (int i = 0; i < 2048; ++i) {
+  for (int i = 0; i < C8_GFX_WIDTH; ++i) {
     this->graphicsBuffer[i] = 0;
   }
+  this->dirtyRows = 0;
 
   for (int i = 0; i < 16; ++i) {
     this->registers[i] = 0;
@@ -27,7 +49,15 @@ Processor::Chip8::Chip8(const char *file_path)
     this->key[i] = 0;
   }
 
-  srand (time(NULL));
+  seedRandom(this->random, time(NULL));
+}
+
+Processor::Chip8::~Chip8()
+{
+  delete this->blockCache;
+  delete this->jit;
+  delete this->precompiled;
+  delete this->traceRing;
 }
 
 void
@@ -35,8 +65,8 @@ Processor::Chip8::initialize()
 {
   char byte;
   int i = 0;
-  this->file = std::ifstream(this->filename, std::ios::binary);
-  while( this->file.get(byte) )
+  std::ifstream file(this->filename.c_str(), std::ios::binary);
+  while( file.get(byte) )
   {
     this->memory[i + C8_MEMORY_OFFSET] = (uint8_t)byte;
     i++;
@@ -47,28 +77,224 @@ Processor::Chip8::initialize()
     this->memory[i] = chip8_fontset[i];
   }
 
-  // Instruction Handlers
-  this->instructions[0x0000] = &Chip8::return_clear_screen;       // validated
-  this->instructions[0x1000] = &Chip8::jp_addr;                   // validated
-  this->instructions[0x2000] = &Chip8::call_addr;                 // validated
-  this->instructions[0x3000] = &Chip8::se_vx_byte;                // validated
-  this->instructions[0x4000] = &Chip8::sne_vx_byte;               // validated
-  this->instructions[0x6000] = &Chip8::ld_vx_byte;                // validated
-  this->instructions[0x7000] = &Chip8::add_vx_byte;               // validated
-  this->instructions[0x8000] = &Chip8::register_vx_vy_byte;       // validated
-  this->instructions[0xA000] = &Chip8::ld_i_addr;
-  this->instructions[0xC000] = &Chip8::rnd_vx_byte;
-  this->instructions[0xD000] = &Chip8::drw_vx_vy_nibble;
-  this->instructions[0xE000] = &Chip8::ex_skip;
-  this->instructions[0xF000] = &Chip8::fx_entrance;
-    // 0xF instructions
-    this->fxInstructions[0x0007] = &Chip8::fx_ld_vx_dt;
-    this->fxInstructions[0x0015] = &Chip8::fx_ld_dt_vx;
-    this->fxInstructions[0x0018] = &Chip8::fx_ld_st_vx;
-    this->fxInstructions[0x0029] = &Chip8::fx_ld_f_vx;
-    this->fxInstructions[0x0033] = &Chip8::fx_ld_b_vx;
-    this->fxInstructions[0x0065] = &Chip8::fx_ld_vx_i;
-    this->fxInstructions[0x001E] = &Chip8::fx_add_i_vx;
+  // processors may be initialized on several threads at once
+  std::call_once(Chip8::decodeTableBuilt, &Chip8::buildDecodeTable);
+}
+
+// handler specializations for every Vx
+#define C8_X(handler)                                                                            \
+  { &Chip8::handler<0x0>, &Chip8::handler<0x1>, &Chip8::handler<0x2>, &Chip8::handler<0x3>,      \
+    &Chip8::handler<0x4>, &Chip8::handler<0x5>, &Chip8::handler<0x6>, &Chip8::handler<0x7>,      \
+    &Chip8::handler<0x8>, &Chip8::handler<0x9>, &Chip8::handler<0xA>, &Chip8::handler<0xB>,      \
+    &Chip8::handler<0xC>, &Chip8::handler<0xD>, &Chip8::handler<0xE>, &Chip8::handler<0xF> }
+
+#define C8_X_KK(handler, KK)                                                                     \
+  { &Chip8::handler<0x0, KK>, &Chip8::handler<0x1, KK>, &Chip8::handler<0x2, KK>,                \
+    &Chip8::handler<0x3, KK>, &Chip8::handler<0x4, KK>, &Chip8::handler<0x5, KK>,                \
+    &Chip8::handler<0x6, KK>, &Chip8::handler<0x7, KK>, &Chip8::handler<0x8, KK>,                \
+    &Chip8::handler<0x9, KK>, &Chip8::handler<0xA, KK>, &Chip8::handler<0xB, KK>,                \
+    &Chip8::handler<0xC, KK>, &Chip8::handler<0xD, KK>, &Chip8::handler<0xE, KK>,                \
+    &Chip8::handler<0xF, KK> }
+
+// ... and for every Vx, Vy pair of one 8xyN sub-operation
+#define C8_XY_ROW(handler, X, N)                                                                 \
+  { &Chip8::handler<X, 0x0, N>, &Chip8::handler<X, 0x1, N>, &Chip8::handler<X, 0x2, N>,          \
+    &Chip8::handler<X, 0x3, N>, &Chip8::handler<X, 0x4, N>, &Chip8::handler<X, 0x5, N>,          \
+    &Chip8::handler<X, 0x6, N>, &Chip8::handler<X, 0x7, N>, &Chip8::handler<X, 0x8, N>,          \
+    &Chip8::handler<X, 0x9, N>, &Chip8::handler<X, 0xA, N>, &Chip8::handler<X, 0xB, N>,          \
+    &Chip8::handler<X, 0xC, N>, &Chip8::handler<X, 0xD, N>, &Chip8::handler<X, 0xE, N>,          \
+    &Chip8::handler<X, 0xF, N> }
+
+#define C8_XY(handler, N)                                                                        \
+  { C8_XY_ROW(handler, 0x0, N), C8_XY_ROW(handler, 0x1, N), C8_XY_ROW(handler, 0x2, N),          \
+    C8_XY_ROW(handler, 0x3, N), C8_XY_ROW(handler, 0x4, N), C8_XY_ROW(handler, 0x5, N),          \
+    C8_XY_ROW(handler, 0x6, N), C8_XY_ROW(handler, 0x7, N), C8_XY_ROW(handler, 0x8, N),          \
+    C8_XY_ROW(handler, 0x9, N), C8_XY_ROW(handler, 0xA, N), C8_XY_ROW(handler, 0xB, N),          \
+    C8_XY_ROW(handler, 0xC, N), C8_XY_ROW(handler, 0xD, N), C8_XY_ROW(handler, 0xE, N),          \
+    C8_XY_ROW(handler, 0xF, N) }
+
+/*
+  Maps an opcode to its handler and splits out the operand fields.
+
+  Handlers are template specializations with the registers (and for 8xyN
+  the sub-operation) baked in, so each compiles down to a couple of
+  instructions without masking, shifting or switching. Immediate bytes and
+  addresses still come from the decoded fields, which keeps the generated
+  set to 16 variants per family and 2304 for the 8xyN grid.
+
+  Instruction Example:
+    0xd235
+
+      nnn: 0x235
+      x:   0x2
+      y:   0x3
+      n:   0x5
+      kk:  0x35
+*/
+Processor::Chip8::Instruction
+Processor::Chip8::decode(uint16_t opCode)
+{
+  static const instructionHandle ldVxByte[16]  = C8_X(ld_vx_byte);
+  static const instructionHandle addVxByte[16] = C8_X(add_vx_byte);
+  static const instructionHandle seVxByte[16]  = C8_X(se_vx_byte);
+  static const instructionHandle sneVxByte[16] = C8_X(sne_vx_byte);
+  static const instructionHandle rndVxByte[16] = C8_X(rnd_vx_byte);
+  static const instructionHandle fxLdVxDt[16]  = C8_X(fx_ld_vx_dt);
+  static const instructionHandle fxLdDtVx[16]  = C8_X(fx_ld_dt_vx);
+  static const instructionHandle fxLdStVx[16]  = C8_X(fx_ld_st_vx);
+  static const instructionHandle fxLdVxK[16]   = C8_X(fx_ld_vx_k);
+  static const instructionHandle fxLdFVx[16]   = C8_X(fx_ld_f_vx);
+  static const instructionHandle fxLdBVx[16]   = C8_X(fx_ld_b_vx);
+  static const instructionHandle fxLdVxI[16]   = C8_X(fx_ld_vx_i);
+  static const instructionHandle fxAddIVx[16]  = C8_X(fx_add_i_vx);
+  static const instructionHandle exSkp[16]     = C8_X_KK(ex_skip, 0x9E);
+  static const instructionHandle exSknp[16]    = C8_X_KK(ex_skip, 0xA1);
+
+  // sub-operations 0 - 7 and E, by x, by y
+  static const instructionHandle registerVxVyByte[9][16][16] = {
+    C8_XY(register_vx_vy_byte, 0x0), C8_XY(register_vx_vy_byte, 0x1), C8_XY(register_vx_vy_byte, 0x2),
+    C8_XY(register_vx_vy_byte, 0x3), C8_XY(register_vx_vy_byte, 0x4), C8_XY(register_vx_vy_byte, 0x5),
+    C8_XY(register_vx_vy_byte, 0x6), C8_XY(register_vx_vy_byte, 0x7), C8_XY(register_vx_vy_byte, 0xE)
+  };
+
+  Instruction decoded;
+  decoded.handler   = &Chip8::unimplemented;
+  decoded.operation = OP_UNIMPLEMENTED;
+  decoded.nnn       = opCode & 0x0FFF;
+  decoded.x         = (opCode & 0x0F00) >> 8;
+  decoded.y         = (opCode & 0x00F0) >> 4;
+  decoded.n         = opCode & 0x000F;
+  decoded.kk        = opCode & 0x00FF;
+
+  switch (opCode & 0xF000)
+  {
+    case 0x0000:
+      decoded.handler = &Chip8::return_clear_screen;    // validated
+      switch (decoded.n)
+      {
+        case 0x0: decoded.operation = OP_CLS; break;
+        case 0xE: decoded.operation = OP_RET; break;
+      }
+      break;
+    case 0x1000:
+      decoded.handler   = &Chip8::jp_addr;              // validated
+      decoded.operation = OP_JP_ADDR;
+      break;
+    case 0x2000:
+      decoded.handler   = &Chip8::call_addr;            // validated
+      decoded.operation = OP_CALL_ADDR;
+      break;
+    case 0x3000:
+      decoded.handler   = seVxByte[decoded.x];           // validated
+      decoded.operation = OP_SE_VX_BYTE;
+      break;
+    case 0x4000:
+      decoded.handler   = sneVxByte[decoded.x];          // validated
+      decoded.operation = OP_SNE_VX_BYTE;
+      break;
+    case 0x6000:
+      decoded.handler   = ldVxByte[decoded.x];           // validated
+      decoded.operation = OP_LD_VX_BYTE;
+      break;
+    case 0x7000:
+      decoded.handler   = addVxByte[decoded.x];          // validated
+      decoded.operation = OP_ADD_VX_BYTE;
+      break;
+    case 0x8000:
+      // validated
+      switch (decoded.n)
+      {
+        case 0x0: decoded.operation = OP_LD_VX_VY; break;
+        case 0x1: decoded.operation = OP_OR_VX_VY; break;
+        case 0x2: decoded.operation = OP_AND_VX_VY; break;
+        case 0x3: decoded.operation = OP_XOR_VX_VY; break;
+        case 0x4: decoded.operation = OP_ADD_VX_VY; break;
+        case 0x5: decoded.operation = OP_SUB_VX_VY; break;
+        case 0x6: decoded.operation = OP_SHR_VX; break;
+        case 0x7: decoded.operation = OP_SUBN_VX_VY; break;
+        case 0xE: decoded.operation = OP_SHL_VX; break;
+      }
+      if ( decoded.operation != OP_UNIMPLEMENTED )
+      {
+        decoded.handler = registerVxVyByte[decoded.n == 0xE ? 8 : decoded.n][decoded.x][decoded.y];
+      }
+      break;
+    case 0xA000:
+      decoded.handler   = &Chip8::ld_i_addr;
+      decoded.operation = OP_LD_I_ADDR;
+      break;
+    case 0xC000:
+      decoded.handler   = rndVxByte[decoded.x];
+      decoded.operation = OP_RND_VX_BYTE;
+      break;
+    case 0xD000:
+      decoded.handler   = &Chip8::drw_vx_vy_nibble;
+      decoded.operation = OP_DRW_VX_VY_NIBBLE;
+      break;
+    case 0xE000:
+      switch (decoded.kk)
+      {
+        case 0x9E:
+          decoded.handler   = exSkp[decoded.x];
+          decoded.operation = OP_SKP_VX;
+          break;
+        case 0xA1:
+          decoded.handler   = exSknp[decoded.x];
+          decoded.operation = OP_SKNP_VX;
+          break;
+      }
+      break;
+    case 0xF000:
+      // there's a lot of 0xFxNN instructions, resolve them here rather than in fx_entrance
+      decoded.handler = &Chip8::fx_entrance;
+      switch (decoded.kk)
+      {
+        case 0x07:
+          decoded.handler   = fxLdVxDt[decoded.x];
+          decoded.operation = OP_LD_VX_DT;
+          break;
+        case 0x0A:
+          decoded.handler   = fxLdVxK[decoded.x];
+          decoded.operation = OP_LD_VX_K;
+          break;
+        case 0x15:
+          decoded.handler   = fxLdDtVx[decoded.x];
+          decoded.operation = OP_LD_DT_VX;
+          break;
+        case 0x18:
+          decoded.handler   = fxLdStVx[decoded.x];
+          decoded.operation = OP_LD_ST_VX;
+          break;
+        case 0x29:
+          decoded.handler   = fxLdFVx[decoded.x];
+          decoded.operation = OP_LD_F_VX;
+          break;
+        case 0x33:
+          decoded.handler   = fxLdBVx[decoded.x];
+          decoded.operation = OP_LD_B_VX;
+          break;
+        case 0x65:
+          decoded.handler   = fxLdVxI[decoded.x];
+          decoded.operation = OP_LD_VX_I;
+          break;
+        case 0x1E:
+          decoded.handler   = fxAddIVx[decoded.x];
+          decoded.operation = OP_ADD_I_VX;
+          break;
+      }
+      break;
+  }
+
+  return decoded;
+}
+
+void
+Processor::Chip8::buildDecodeTable()
+{
+  for (uint32_t opCode = 0; opCode < C8_OPCODE_COUNT; ++opCode)
+  {
+    Chip8::decodeTable[opCode] = Chip8::decode(opCode);
+  }
 }
 
 void
@@ -79,57 +305,901 @@ Processor::Chip8::debugMemory()
   {
     this->memory[i] = chip8_fontset[i];
   }
+  this->invalidateCode(0, 80);
   std::cout << hexdump(this->memory) << std::endl;
 }
 
+/*
+  One trace line for the instruction about to run, see debug/trace.hpp
+*/
 void
-Processor::Chip8::cycle()
+Processor::Chip8::trace(const char *handler) const
 {
+  char line[160];
+  int length = snprintf(line, sizeof(line), "%03X  %04X  %-20s", this->programCounter, this->opCode, handler);
 
-  this->opCode = this->memory[this->programCounter] << 8 | this->memory[this->programCounter + 1];
+#if C8_TRACE_LEVEL >= C8_TRACE_STATE
+  for (int i = 0; i < 16; ++i)
+  {
+    length += snprintf(line + length, sizeof(line) - length, " %02X", this->registers[i]);
+  }
+  snprintf(line + length, sizeof(line) - length, "  I=%03X SP=%X DT=%02X ST=%02X",
+    this->indexRegister, this->sp, this->delayTimer(), this->soundTimer());
+#else
+  (void)length;
+#endif
+
+  // no flush, trace output is buffered like any other stream
+  std::cout << line << '\n';
+}
 
-  /*
-    Instruction Example:
-      0x6a02
+void
+Processor::Chip8::cycle()
+{
 
-    Big Endian:
-      low ---> high
-        02   6a
+  // an instruction at the last address (0xFFF) takes its low byte from 0x000
+  this->opCode = this->memory[this->programCounter & 0xFFF] << 8 | this->memory[(this->programCounter + 1) & 0xFFF];
 
-    Mask:
-      0x026a & 0xF000
-          ^      ^
-          |------|
-      0x026a & 0xF000
-        ^          ^
-        |----------|  
-  */
+  // every opcode was decoded up front, dispatch is a single indexed load
+  this->instruction = &Chip8::decodeTable[this->opCode];
+  C8_PROFILE_INSTRUCTION(this->programCounter, this->opCode, this->instruction->operation);
 
-  uint16_t instruction = this->opCode & 0xF000;
-  if ( this->instructions.count(instruction) )
+  if ( this->traceRing != NULL )
   {
-    (this->*(this->instructions[instruction]))();
+    uint16_t pc = this->programCounter;
+    uint8_t before[16];
+    memcpy(before, this->registers, sizeof(before));
+    (this->*(this->instruction->handler))();
+    this->traceRing->record(this->clock, pc, this->opCode, this->indexRegister, before, this->registers);
   }
   else
   {
-    std::cout << "Unimplemented OpCode: " << hexdump(this->opCode) << std::endl;
-    exit(1);
+    (this->*(this->instruction->handler))();
+  }
+
+  // a halting instruction doesn't count, and time stops with it
+  if (this->halted)
+  {
+    return;
+  }
+  ++this->clock;
+}
+
+/*
+  How many instructions make up one 60 Hz frame of emulated time. The timers
+  keep the values they have now and count down from the next frame boundary.
+*/
+void
+Processor::Chip8::setInstructionsPerFrame(uint32_t instructions)
+{
+  uint8_t delay = this->delayTimer();
+  uint8_t sound = this->soundTimer();
+
+  this->instructionsPerFrame = instructions > 0 ? instructions : 1;
+  this->delayExpires = this->frame() + delay;
+  this->soundExpires = sound != 0 ? this->frame() + sound : 0;
+}
+
+/*
+  Sets a key of the keypad. Unlike writing key[] directly, a key pressed
+  and released again before the next run() still ends an Fx0A wait.
+*/
+void
+Processor::Chip8::press(uint8_t key, bool down)
+{
+  this->key[key & 0xF] = down ? 1 : 0;
+  if ( down && this->keyWait != 0 && this->keyHeld == C8_NO_KEY )
+  {
+    this->keyHeld = key & 0xF;
+  }
+}
+
+/*
+  Seeds RND, each processor has a generator of its own
+*/
+void
+Processor::Chip8::seed(uint32_t value)
+{
+  seedRandom(this->random, value);
+}
+
+void
+Processor::Chip8::setEngine(Engine engine)
+{
+  this->engine = engine;
+
+  if ( engine == ENGINE_BLOCK && this->blockCache == NULL )
+  {
+    this->blockCache = new BlockCache();
+  }
+
+  if ( engine == ENGINE_JIT && this->jit == NULL )
+  {
+    this->jit = new Jit();
+    if ( !this->jit->ready() )
+    {
+      std::cerr << "JIT unavailable on this host, using the dispatch engine" << std::endl;
+      delete this->jit;
+      this->jit = NULL;
+      this->engine = ENGINE_DISPATCH;
+    }
+  }
+
+  if ( engine == ENGINE_PRECOMPILED && this->precompiled == NULL )
+  {
+    const PrecompiledRom *rom = Precompiled::find(this->memory);
+    if ( rom == NULL )
+    {
+      std::cerr << "No precompiled code for " << this->filename << ", using the dispatch engine" << std::endl;
+      this->engine = ENGINE_DISPATCH;
+    }
+    else
+    {
+      this->precompiled = new Precompiled(rom);
+    }
+  }
+}
+
+/*
+  Starts recording every instruction to a binary trace file (see c8trace).
+  While recording, all engines fall back to the dispatch loop.
+*/
+bool
+Processor::Chip8::recordTrace(const char *path)
+{
+  delete this->traceRing;
+  this->traceRing = Debug::TraceRing::open(path);
+  return this->traceRing != NULL;
+}
+
+/*
+  Snapshots are plain copies of the machine state
+*/
+void
+Processor::Chip8::save(Chip8State &state) const
+{
+  memcpy(&state, static_cast<const Chip8State *>(this), sizeof(Chip8State));
+}
+
+void
+Processor::Chip8::load(const Chip8State &state)
+{
+  // only code that actually changed has to be dropped from the engine caches
+  int first = 0;
+  int last = sizeof(this->memory) - 1;
+  while ( first <= last && this->memory[first] == state.memory[first] )
+  {
+    ++first;
+  }
+  while ( last >= first && this->memory[last] == state.memory[last] )
+  {
+    --last;
+  }
+
+  memcpy(static_cast<Chip8State *>(this), &state, sizeof(Chip8State));
+
+  if ( first <= last )
+  {
+    this->invalidateCode(first, last - first + 1);
+  }
+}
+
+/*
+  Must be called whenever memory is written outside of the CPU, so no engine
+  keeps running stale translations of the old bytes.
+*/
+void
+Processor::Chip8::invalidateCode(uint16_t address, uint16_t length)
+{
+  if ( this->blockCache != NULL )
+  {
+    this->blockCache->invalidate(address, length);
+  }
+
+  if ( this->jit != NULL )
+  {
+    this->jit->invalidate(address, length);
+  }
+
+  if ( this->precompiled != NULL )
+  {
+    this->precompiled->invalidate(address, length);
+  }
+}
+
+/*
+  Executes up to `cycles` instructions on the selected engine, stopping early
+  once an instruction asks for the screen to be redrawn.
+  Returns the number of instructions executed.
+*/
+uint32_t
+Processor::Chip8::run(uint32_t cycles)
+{
+  // binary traces are recorded one instruction at a time by cycle(), and so are profiles
+#ifdef C8_PROFILE
+  Engine engine = ENGINE_DISPATCH;
+#else
+  Engine engine = this->traceRing != NULL ? ENGINE_DISPATCH : this->engine;
+#endif
+
+  if (this->halted)
+  {
+    return 0;
+  }
+
+  uint32_t executed = 0;
+  while (true)
+  {
+    // blocked on Fx0A: nothing is fetched, only the clock moves on
+    if (this->awaitKey())
+    {
+      C8_PROFILE_IDLE(this->programCounter, cycles - executed);
+      this->clock += cycles - executed;
+      this->idleCycles += cycles - executed;
+      executed = cycles;
+      break;
+    }
+
+    executed += this->skipIdle(cycles - executed);
+    if (executed == cycles)
+    {
+      break;
+    }
+
+    this->idling = false;
+    uint32_t budget = cycles - executed;
+    if (engine == ENGINE_THREADED)
+    {
+      executed += this->runThreaded(budget);
+    }
+    else if (engine == ENGINE_BLOCK)
+    {
+      executed += this->runBlocks(budget);
+    }
+    else if (engine == ENGINE_JIT)
+    {
+      executed += this->runJit(budget);
+    }
+    else if (engine == ENGINE_PRECOMPILED)
+    {
+      executed += this->runPrecompiled(budget);
+    }
+    else
+    {
+      executed += this->runDispatch(budget);
+    }
+
+    // engines only come back early for draws and halts, or to have an idle loop skipped or a key waited for
+    if (!this->idling || this->drawFlag || this->halted || executed == cycles)
+    {
+      break;
+    }
+  }
+  this->idling = false;
+
+  // nobody can hear the beep before run() returns, so that is when it is checked for
+  this->settleSound();
+  return executed;
+}
+
+/*
+  One instruction at a time through cycle()
+*/
+uint32_t
+Processor::Chip8::runDispatch(uint32_t cycles)
+{
+  uint32_t executed = 0;
+  while (executed < cycles)
+  {
+    this->cycle();
+    if (this->halted)
+    {
+      break;
+    }
+    ++executed;
+    if (this->drawFlag || this->idling)
+    {
+      break;
+    }
+  }
+  return executed;
+}
+
+/*
+  Direct-threaded interpreter (GCC/Clang labels-as-values).
+
+  Each operation body ends by advancing the clock, fetching the next opcode
+  and jumping straight to its label, so there is no call or return per
+  instruction. Semantics mirror the handlers below exactly; anything rare
+  (unimplemented opcodes) is handed to its handler. The per-instruction
+  logging of the handlers is not reproduced here.
+*/
+uint32_t
+Processor::Chip8::runThreaded(uint32_t cycles)
+{
+  // indexed by Processor::Operation
+  static void *labels[OP_COUNT] = {
+    &&op_unimplemented,
+    &&op_cls,
+    &&op_ret,
+    &&op_jp_addr,
+    &&op_call_addr,
+    &&op_se_vx_byte,
+    &&op_sne_vx_byte,
+    &&op_ld_vx_byte,
+    &&op_add_vx_byte,
+    &&op_ld_vx_vy,
+    &&op_or_vx_vy,
+    &&op_and_vx_vy,
+    &&op_xor_vx_vy,
+    &&op_add_vx_vy,
+    &&op_sub_vx_vy,
+    &&op_shr_vx,
+    &&op_subn_vx_vy,
+    &&op_shl_vx,
+    &&op_ld_i_addr,
+    &&op_rnd_vx_byte,
+    &&op_drw_vx_vy_nibble,
+    &&op_skp_vx,
+    &&op_sknp_vx,
+    &&op_ld_vx_dt,
+    &&op_ld_dt_vx,
+    &&op_ld_st_vx,
+    &&op_add_i_vx,
+    &&op_ld_f_vx,
+    &&op_ld_b_vx,
+    &&op_ld_vx_i,
+    &&op_ld_vx_k
+  };
+
+  uint8_t  *V = this->registers;
+  uint32_t executed = 0;
+  const Instruction *op;
+
+  #define C8_FETCH()                                                                                      \
+    this->opCode = this->memory[this->programCounter & 0xFFF] << 8                                        \
+                 | this->memory[(this->programCounter + 1) & 0xFFF];                                      \
+    op = &Chip8::decodeTable[this->opCode];                                                               \
+    goto *labels[op->operation];
+
+  #define C8_NEXT()                                                                                       \
+    ++this->clock;                                                                                        \
+    if ( ++executed == cycles ) goto done;                                                                \
+    C8_FETCH()
+
+  // the screen needs redrawing, hand control back to the host
+  #define C8_YIELD()                                                                                      \
+    ++this->clock;                                                                                        \
+    ++executed;                                                                                           \
+    goto done;
+
+  if (cycles == 0)
+  {
+    return 0;
+  }
+  C8_FETCH()
+
+  op_unimplemented:
+    this->instruction = op;
+    (this->*(op->handler))();
+    if (this->halted)
+    {
+      goto done;
+    }
+    C8_NEXT()
+
+  op_cls:
+    this->clearScreen();
+    this->drawFlag = true;
+    this->programCounter += 2;
+    C8_YIELD()
+
+  op_ret:
+    --this->sp;
+    this->programCounter = this->stack[this->sp & 0xF] + 2;
+    C8_NEXT()
+
+  op_jp_addr:
+    if ( op->nnn <= this->programCounter && this->idleLoopAt(op->nnn) != IDLE_NONE )
+    {
+      this->programCounter = op->nnn;
+      this->idling = true;
+      C8_YIELD()
+    }
+    this->programCounter = op->nnn;
+    C8_NEXT()
+
+  op_call_addr:
+    this->stack[this->sp & 0xF] = this->programCounter;
+    ++this->sp;
+    this->programCounter = op->nnn;
+    C8_NEXT()
+
+  op_se_vx_byte:
+    this->programCounter += ( V[op->x] == op->kk ) ? 4 : 2;
+    C8_NEXT()
+
+  op_sne_vx_byte:
+    this->programCounter += ( V[op->x] != op->kk ) ? 4 : 2;
+    C8_NEXT()
+
+  op_ld_vx_byte:
+    V[op->x] = op->kk;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_add_vx_byte:
+    V[op->x] += op->kk;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_ld_vx_vy:
+    V[op->x] = V[op->y];
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_or_vx_vy:
+    V[op->x] |= V[op->y];
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_and_vx_vy:
+    V[op->x] &= V[op->y];
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_xor_vx_vy:
+    V[op->x] ^= V[op->y];
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_add_vx_vy:
+    V[op->x] += V[op->y];
+    V[0xF] = 0;
+    if ( V[op->y] > (0xFF - V[op->x]) )
+    {
+      V[0xF] = 1;
+    }
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_sub_vx_vy:
+    V[0xF] = 1;
+    if ( V[op->y] > V[op->x] )
+    {
+      V[0xF] = 0;
+    }
+    V[op->x] -= V[op->y];
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_shr_vx:
+    V[0xF] = V[op->x] & 0x1;
+    V[op->x] >>= 1;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_subn_vx_vy:
+    V[0xF] = 1;
+    if ( V[op->x] > V[op->y] )
+    {
+      V[0xF] = 0;
+    }
+    V[op->x] = V[op->y] - V[op->x];
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_shl_vx:
+    V[0xF] = V[op->x] >> 7;
+    V[op->x] <<= 1;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_ld_i_addr:
+    this->indexRegister = op->nnn;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_rnd_vx_byte:
+    V[op->x] = (nextRandom(this->random) % (0xFF + 1)) & op->kk;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_drw_vx_vy_nibble:
+    this->draw(op->x, op->y, op->n);
+    this->programCounter += 2;
+    C8_YIELD()
+
+  op_skp_vx:
+    this->programCounter += ( this->key[V[op->x] & 0xF] != 0 ) ? 4 : 2;
+    C8_NEXT()
+
+  op_sknp_vx:
+    this->programCounter += ( this->key[V[op->x] & 0xF] == 0 ) ? 4 : 2;
+    C8_NEXT()
+
+  op_ld_vx_dt:
+    V[op->x] = this->delayTimer();
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_ld_dt_vx:
+    this->setDelayTimer(V[op->x]);
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_ld_st_vx:
+    this->setSoundTimer(V[op->x]);
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_add_i_vx:
+  {
+    uint8_t value = V[op->x];
+    V[0xF] = 0;
+    if ( (this->indexRegister + value) > 0xFFF )
+    {
+      V[0xF] = 1;
+    }
+    this->indexRegister += value;
+    this->programCounter += 2;
+    C8_NEXT()
   }
 
-  if (this->delayTimer > 0)
+  op_ld_f_vx:
+    this->indexRegister = V[op->x] * 0x5;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_ld_b_vx:
+    this->storeBCD(op->x);
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_ld_vx_i:
+    for (int i = 0; i <= op->x; ++i)
+    {
+      V[i] = this->memory[(this->indexRegister + i) & 0xFFF];
+    }
+    this->indexRegister += op->x + 1;
+    this->programCounter += 2;
+    C8_NEXT()
+
+  op_ld_vx_k:
+    this->keyWait = C8_KEY_WAIT | op->x;
+    this->keyHeld = C8_NO_KEY;
+    this->idling = true;
+    C8_YIELD()
+
+  done:
+    #undef C8_FETCH
+    #undef C8_NEXT
+    #undef C8_YIELD
+    return executed;
+}
+
+/*
+  Runs cached basic blocks: the code at the program counter is decoded once
+  into micro-ops, and later visits replay them without touching memory[].
+  A block stops early if one of its own instructions overwrote cached code.
+*/
+uint32_t
+Processor::Chip8::runBlocks(uint32_t cycles)
+{
+  uint32_t executed = 0;
+  while (executed < cycles)
   {
-    --this->delayTimer;
+    // blocks end before the last address, the instruction there wraps around and runs the way dispatch does
+    if ( this->programCounter >= 0xFFF )
+    {
+      this->cycle();
+      if (this->halted)
+      {
+        return executed;
+      }
+      ++executed;
+      if (this->drawFlag || this->idling)
+      {
+        break;
+      }
+      continue;
+    }
+
+    const Block *block = this->blockCache->lookup(this->programCounter);
+    if ( block == NULL )
+    {
+      block = this->blockCache->build(this->programCounter, this->memory, Chip8::decodeTable);
+    }
+
+    const Instruction * const *ops = this->blockCache->microOps(block);
+    uint16_t length = block->length;
+    uint32_t generation = this->blockCache->generation;
+
+    for (uint16_t i = 0; i < length && executed < cycles; ++i)
+    {
+      this->instruction = ops[i];
+      this->opCode = ops[i] - Chip8::decodeTable;   // the table is indexed by opcode
+      (this->*(this->instruction->handler))();
+      if (this->halted)
+      {
+        return executed;
+      }
+      ++this->clock;
+      ++executed;
+
+      if ( this->blockCache->generation != generation )
+      {
+        break;
+      }
+    }
+
+    if (this->drawFlag || this->idling)
+    {
+      break;
+    }
   }
+  return executed;
+}
 
-  if (this->soundTimer > 0)
+/*
+  Runs recompiled code wherever the JIT could compile the program counter's
+  block, and interprets a single instruction everywhere else. Compiled blocks
+  never look at the timers, so the clock is caught up once control comes back.
+*/
+uint32_t
+Processor::Chip8::runJit(uint32_t cycles)
+{
+  uint32_t executed = 0;
+  JitContext context;
+
+  while (executed < cycles)
   {
-    if (this->soundTimer == 1)
+    const uint8_t *code = this->jit->lookup(this->programCounter, this->memory, Chip8::decodeTable);
+    if ( code != NULL )
     {
-      // BEEP!
-      std::cout << '\7';
+      memcpy(context.V, this->registers, sizeof(this->registers));
+      context.I        = this->indexRegister;
+      context.pc       = this->programCounter;
+      context.budget   = cycles - executed;
+      context.executed = 0;
+
+      this->jit->enter(&context, code);
+
+      memcpy(this->registers, context.V, sizeof(this->registers));
+      this->indexRegister  = context.I;
+      this->programCounter = context.pc;
+      this->clock += context.executed;
+      executed += context.executed;
+
+      // zero means the block didn't fit in what's left of the budget
+      if ( context.executed > 0 )
+      {
+        continue;
+      }
+    }
+
+    this->cycle();
+    if (this->halted)
+    {
+      break;
+    }
+    ++executed;
+    if (this->drawFlag || this->idling)
+    {
+      break;
     }
-    --this->soundTimer;
   }
+  return executed;
+}
+
+/*
+  Runs the blocks c8rc translated for this ROM. Addresses it could not reach
+  statically (computed jumps) and code that was overwritten since are
+  interpreted instead, as is the tail of the budget too short for a block.
+*/
+uint32_t
+Processor::Chip8::runPrecompiled(uint32_t cycles)
+{
+  uint32_t executed = 0;
+  while (executed < cycles)
+  {
+    const PrecompiledBlock *block = this->precompiled->lookup(this->programCounter);
+    if ( block != NULL && block->length <= cycles - executed )
+    {
+      block->run(*this);
+      executed += block->length;
+    }
+    else
+    {
+      this->cycle();
+      if (this->halted)
+      {
+        break;
+      }
+      ++executed;
+    }
+
+    if (this->drawFlag || this->idling)
+    {
+      break;
+    }
+  }
+  return executed;
+}
+
+/*
+  Recognises the loops ROMs wait in, at `address`, that would spin right now:
+  a jump to itself, a key check whose key isn't in the state it waits for,
+  and a delay timer poll while the timer is still running. None of them
+  changes anything but the clock (and the register DT is read into) until
+  the timer runs out or the host changes a key, which it only does between
+  runs.
+*/
+Processor::IdleLoop
+Processor::Chip8::idleLoopAt(uint16_t address) const
+{
+  if ( address > sizeof(this->memory) - 6 )
+  {
+    return IDLE_NONE;
+  }
+  const uint8_t *code = this->memory + address;
+  uint16_t first  = code[0] << 8 | code[1];
+  uint16_t second = code[2] << 8 | code[3];
+  uint16_t third  = code[4] << 8 | code[5];
+  uint16_t back   = 0x1000 | address;
+  uint8_t  x      = first >> 8 & 0xF;
+
+  if ( first == back )
+  {
+    return IDLE_JUMP;
+  }
+
+  if ( second == back )
+  {
+    bool pressed = this->key[this->registers[x] & 0xF] != 0;
+    if ( ((first & 0xF0FF) == 0xE09E && !pressed) || ((first & 0xF0FF) == 0xE0A1 && pressed) )
+    {
+      return IDLE_KEY;
+    }
+  }
+
+  if ( (first & 0xF0FF) == 0xF007 && second == (0x3000 | x << 8) && third == back && this->delayTimer() > 0 )
+  {
+    return IDLE_TIMER;
+  }
+  return IDLE_NONE;
+}
+
+/*
+  Nothing but a key changing can get the program going again, and no timer
+  is left running that the program (or the speaker) would notice
+*/
+bool
+Processor::Chip8::waitingForInput() const
+{
+  if ( this->delayTimer() > 0 || this->soundTimer() > 0 )
+  {
+    return false;
+  }
+
+  // an Fx0A wait whose key went down and up again completes on the next run()
+  if ( this->keyWait != 0 )
+  {
+    return this->keyHeld == C8_NO_KEY || this->key[this->keyHeld] != 0;
+  }
+
+  IdleLoop loop = this->idleLoopAt(this->programCounter);
+  return loop == IDLE_JUMP || loop == IDLE_KEY;
+}
+
+/*
+  Moves an Fx0A wait along with the keypad: the first key seen down is the
+  one that counts, and once it is up again it goes into Vx and the program
+  continues after Fx0A. Returns whether the processor is still blocked.
+*/
+bool
+Processor::Chip8::awaitKey()
+{
+  if ( this->keyWait == 0 )
+  {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < 16 && this->keyHeld == C8_NO_KEY; ++i)
+  {
+    if ( this->key[i] != 0 )
+    {
+      this->keyHeld = i;
+    }
+  }
+
+  if ( this->keyHeld == C8_NO_KEY || this->key[this->keyHeld] != 0 )
+  {
+    return true;
+  }
+
+  this->registers[this->keyWait & 0xF] = this->keyHeld;
+  this->keyWait = 0;
+  this->keyHeld = C8_NO_KEY;
+  this->programCounter += 2;
+  return false;
+}
+
+/*
+  Fast-forwards through the idle loop at the program counter, if there is
+  one, for at most `cycles` instructions: the clock and registers end up
+  exactly where executing them would have left them. Returns the number of
+  instructions skipped.
+*/
+uint32_t
+Processor::Chip8::skipIdle(uint32_t cycles)
+{
+  // a trace has to see every instruction
+  if ( this->traceRing != NULL )
+  {
+    return 0;
+  }
+
+  uint32_t skipped = 0;
+  switch ( this->idleLoopAt(this->programCounter) )
+  {
+    case IDLE_NONE:
+      return 0;
+
+    case IDLE_JUMP:
+      skipped = cycles;
+      break;
+
+    case IDLE_KEY:
+      skipped = cycles - cycles % 2;
+      break;
+
+    case IDLE_TIMER:
+    {
+      // every iteration that reads a running timer goes around again
+      uint64_t expired = this->delayExpires * this->instructionsPerFrame;
+      uint64_t iterations = (expired - this->clock + 2) / 3;
+      if ( iterations > cycles / 3 )
+      {
+        iterations = cycles / 3;
+      }
+      if ( iterations == 0 )
+      {
+        return 0;
+      }
+      uint8_t x = this->memory[this->programCounter] & 0xF;
+      this->clock += (iterations - 1) * 3;
+      this->registers[x] = this->delayTimer();
+      this->clock += 3;
+      this->idleCycles += iterations * 3;
+      C8_PROFILE_IDLE(this->programCounter, iterations * 3);
+      return iterations * 3;
+    }
+  }
+
+  this->clock += skipped;
+  this->idleCycles += skipped;
+  C8_PROFILE_IDLE(this->programCounter, skipped);
+  return skipped;
+}
+
+/*
+  Compares the machine state of two processors: registers, stack, timers,
+  memory and the display.
+*/
+bool
+Processor::Chip8::operator==(const Chip8 &other) const
+{
+  return this->sp == other.sp
+    && this->indexRegister == other.indexRegister
+    && this->programCounter == other.programCounter
+    && this->keyWait == other.keyWait
+    && this->delayTimer() == other.delayTimer()
+    && this->soundTimer() == other.soundTimer()
+    && memcmp(this->stack, other.stack, sizeof(this->stack)) == 0
+    && memcmp(this->registers, other.registers, sizeof(this->registers)) == 0
+    && memcmp(this->memory, other.memory, sizeof(this->memory)) == 0
+    && memcmp(this->graphicsBuffer, other.graphicsBuffer, sizeof(this->graphicsBuffer)) == 0;
 }
 
 /*
@@ -138,27 +1208,25 @@ Processor::Chip8::cycle()
 void
 Processor::Chip8::return_clear_screen()
 {
-  std::cout << "return_clear_screen: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("return_clear_screen");
 
-  switch( this->opCode & 0x000F)
+  switch( this->instruction->n )
   {
     // clear screen
     case 0x0000:
-        for (int i = 0; i < 2048; ++i) {
-          this->graphicsBuffer[i] = 0;
-        }
+        this->clearScreen();
         this->drawFlag = true;
         this->programCounter += 2;
       break;
     // return from subroutine
     case 0x000E:
+      C8_PROFILE_RETURN();
       --this->sp;
-      this->programCounter = this->stack[this->sp];
+      this->programCounter = this->stack[this->sp & 0xF];
       this->programCounter += 2;
       break;
     default:
-      std::cout << "Unimplemented OpCode: " << hexdump(this->opCode) << std::endl;
-      exit(1);
+      this->unimplemented();
   }
 }
 
@@ -167,12 +1235,13 @@ Processor::Chip8::return_clear_screen()
     Set Vx = kk.
     The interpreter puts the value kk into register Vx.
 */
+template<uint8_t X>
 void
 Processor::Chip8::ld_vx_byte()
 {
-  std::cout << "ld_vx_byte: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("ld_vx_byte");
 
-  this->registers[MASK(0x0F00) >> 8] = MASK(0x00FF);
+  this->registers[X] = this->instruction->kk;
   this->programCounter += 2;
 }
 
@@ -184,9 +1253,9 @@ Processor::Chip8::ld_vx_byte()
 void
 Processor::Chip8::ld_i_addr()
 {
-  std::cout << "ld_i_addr: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("ld_i_addr");
 
-  this->indexRegister = (this->opCode & 0x0FFF);
+  this->indexRegister = this->instruction->nnn;
   this->programCounter += 2;
 }
 
@@ -206,45 +1275,44 @@ Processor::Chip8::ld_i_addr()
 void
 Processor::Chip8::drw_vx_vy_nibble()
 {
-  std::cout << "drw_vx_vy_nibble: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("drw_vx_vy_nibble");
 
-  unsigned short xCoord = this->registers[MASK(0x0F00) >> 8];
-  unsigned short yCoord = this->registers[MASK(0x00F0) >> 4];
-  unsigned short height = MASK(0x000F);
-  unsigned short pixel;
+  this->draw(this->instruction->x, this->instruction->y, this->instruction->n);
+  this->programCounter += 2;
+}
+
+/*
+  Shared sprite drawing for every engine, see drw_vx_vy_nibble
+*/
+void
+Processor::Chip8::draw(uint8_t x, uint8_t y, uint8_t height)
+{
+  unsigned short xCoord = this->registers[x];
+  unsigned short yCoord = this->registers[y];
 
   // reset register (V)F to 0 as nothing is erased (yet)
   this->registers[0xF] = 0;
 
-  // draw vertical (y line)
+  // one framebuffer row per sprite byte, wrapping at the edges of the screen
   for ( int yline = 0; yline < height; yline++ )
   {
-    // fetch each pixel value starting from the indexRegister
-    pixel = this->memory[this->indexRegister + yline];
+    uint64_t sprite = spriteRow(this->memory[(this->indexRegister + yline) & 0xFFF], xCoord);
+    unsigned int rowIndex = (yCoord + yline) % C8_GFX_WIDTH;
+    uint64_t &row = this->graphicsBuffer[rowIndex];
 
-    // the width is 8 pixels
-    for ( int xline = 0; xline < 8; xline++ )
+    // any pixel turned off by the XOR is a collision
+    if ( (row & sprite) != 0 )
     {
-      // scan, one byte at a time, if the current EVALUATED pixel is set to 1
-      if ( (pixel & (0x80 >> xline)) != 0 ) // 0x80 = 128
-      {
-        // check if the current pixel on display is set to 1,
-        // if so, we register the collision by setting register (V)F to 1
-        //int offset = (xCoord + y + ((yCoord + w) * C8_GFX_LENGTH));
-        int offset = (xCoord + xline + ((yCoord + yline) * C8_GFX_LENGTH));
-        if ( this->graphicsBuffer[offset] == 1 )
-        {
-          this->registers[0xF] = 1;
-        }
-        // XOR the pixel to redraw the screen
-        this->graphicsBuffer[offset] ^= 1;
-      }
+      this->registers[0xF] = 1;
+    }
+    row ^= sprite;
+    if ( sprite != 0 )
+    {
+      this->dirtyRows |= 1U << rowIndex;
     }
   }
   // redraw the screen
   this->drawFlag = true;
-  this->programCounter += 2;
-
 }
 
 /*
@@ -256,8 +1324,14 @@ Processor::Chip8::drw_vx_vy_nibble()
 void
 Processor::Chip8::jp_addr()
 {
-  std::cout << "jp_addr: " << hexdump(this->opCode) << std::endl;
-  this->programCounter = this->opCode & 0x0FFF;
+  C8_TRACE("jp_addr");
+
+  // jumping back into an idle loop, have run() skip it
+  if ( this->instruction->nnn <= this->programCounter && this->idleLoopAt(this->instruction->nnn) != IDLE_NONE )
+  {
+    this->idling = true;
+  }
+  this->programCounter = this->instruction->nnn;
 }
 
 /*
@@ -268,11 +1342,12 @@ Processor::Chip8::jp_addr()
 void
 Processor::Chip8::call_addr()
 {
-  std::cout << "call_addr: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("call_addr");
+  C8_PROFILE_CALL(this->instruction->nnn);
 
-  this->stack[this->sp] = this->programCounter;
+  this->stack[this->sp & 0xF] = this->programCounter;
   ++this->sp;
-  this->programCounter = this->opCode & 0x0FFF;
+  this->programCounter = this->instruction->nnn;
 }
 
 /*
@@ -281,10 +1356,11 @@ Processor::Chip8::call_addr()
 
     The interpreter compares register Vx to kk, and if they are equal, increments the program counter by 2.
 */
+template<uint8_t X>
 void
 Processor::Chip8::se_vx_byte()
 {
-  if ( this->registers[MASK(0x0F00) >> 8] == MASK(0x00FF) )
+  if ( this->registers[X] == this->instruction->kk )
   {
     this->programCounter += 4;
   }
@@ -301,10 +1377,11 @@ Processor::Chip8::se_vx_byte()
     The interpreter compares register Vx to kk, and if they are not equal,
     increments the program counter by 2.
 */
+template<uint8_t X>
 void
 Processor::Chip8::sne_vx_byte()
 {
-  if ( this->registers[MASK(0x0F00) >> 8] != MASK(0x00FF) )
+  if ( this->registers[X] != this->instruction->kk )
   {
     this->programCounter += 4;
   }
@@ -315,20 +1392,23 @@ Processor::Chip8::sne_vx_byte()
 }
 
 /*
-  Handles FxNN instruction mapping
+  Any opcode the decoder has no handler for
+*/
+void
+Processor::Chip8::unimplemented()
+{
+  std::cerr << "Unimplemented OpCode: " << hexdump(this->opCode) << std::endl;
+  this->halted = true;
+}
+
+/*
+  FxNN instructions without a handler of their own
 */
 void
 Processor::Chip8::fx_entrance()
 {
-  uint16_t instruction = this->opCode & 0x00FF;
-  if ( this->fxInstructions.count(instruction) )
-  {
-    (this->*(this->fxInstructions[instruction]))();
-  }
-  else
-  {
-    std::cout << "Unimplemented FX OpCode: " << hexdump(this->opCode) << std::endl;
-  }
+  std::cerr << "Unimplemented FX OpCode: " << hexdump(this->opCode) << std::endl;
+  this->halted = true;
 }
 
 /*
@@ -337,27 +1417,51 @@ Processor::Chip8::fx_entrance()
 
     The value of DT is placed into Vx.
 */
+template<uint8_t X>
 void
 Processor::Chip8::fx_ld_vx_dt()
 {
-  std::cout << "fx_ld_vx_dt: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("fx_ld_vx_dt");
 
-  this->registers[(this->opCode & 0x0F00) >> 8] = this->delayTimer;
+  this->registers[X] = this->delayTimer();
   this->programCounter += 2;
 }
 
+/*
+  Fx0A - LD Vx, K
+    Wait for a key press, store the value of the key in Vx.
+
+    All execution stops until a key is pressed, then the value of that key
+    is stored in Vx.
+
+  Rather than executing this over and over, the processor blocks: run()
+  stops fetching and lets the clock run on until awaitKey() sees a key
+  pressed and released.
+*/
+template<uint8_t X>
+void
+Processor::Chip8::fx_ld_vx_k()
+{
+  C8_TRACE("fx_ld_vx_k");
+
+  this->keyWait = C8_KEY_WAIT | X;
+  this->keyHeld = C8_NO_KEY;
+  this->idling = true;
+}
+
 /*
   Fx15 - LD DT, Vx
     Set delay timer = Vx.
 
     DT is set equal to the value of Vx.
 */
+template<uint8_t X>
 void
 Processor::Chip8::fx_ld_dt_vx()
 {
-  std::cout << "fx_ld_dt_vx: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("fx_ld_dt_vx");
 
-  this->delayTimer = this->registers[(this->opCode & 0x0F00) >> 8];
+  this->setDelayTimer(this->registers[X]);
   this->programCounter += 2;
 }
 
@@ -369,10 +1473,11 @@ Processor::Chip8::fx_ld_dt_vx()
     ST is set equal to the value of Vx.
 
 */
+template<uint8_t X>
 void
 Processor::Chip8::fx_ld_st_vx()
 {
-  this->soundTimer = this->registers[MASK(0x0F00) >> 8];
+  this->setSoundTimer(this->registers[X]);
   this->programCounter += 2;
 }
 
@@ -383,34 +1488,49 @@ Fx33 - LD B, Vx
   The interpreter takes the decimal value of Vx, and places the hundreds digit in memory at location in I, 
   the tens digit at location I+1, and the ones digit at location I+2.
 */
+template<uint8_t X>
 void
 Processor::Chip8::fx_ld_b_vx()
 {
-  std::cout << "fx_ld_b_vx: " << hexdump(this->opCode) << std::endl;
-
-  this->memory[this->indexRegister]     = (this->registers[(this->opCode & 0x0F00) >> 8]) / 100;
-  this->memory[this->indexRegister + 1] = ((this->registers[(this->opCode & 0x0F00) >> 8]) / 10) % 10;
-  this->memory[this->indexRegister + 2] = ((this->registers[(this->opCode & 0x0F00) >> 8]) % 100) % 10;
+  C8_TRACE("fx_ld_b_vx");
 
+  this->storeBCD(X);
   this->programCounter += 2;
 }
 
+void
+Processor::Chip8::storeBCD(uint8_t x)
+{
+  // I can point anywhere, addresses wrap around at 4k like the fetch does
+  uint16_t address = this->indexRegister & 0xFFF;
+  this->memory[address]               = (this->registers[x]) / 100;
+  this->memory[(address + 1) & 0xFFF] = ((this->registers[x]) / 10) % 10;
+  this->memory[(address + 2) & 0xFFF] = ((this->registers[x]) % 100) % 10;
+
+  this->invalidateCode(address, 3);
+  if ( address > 0xFFD )
+  {
+    this->invalidateCode(0, address - 0xFFD);
+  }
+}
+
 /*
   Fx65 - LD Vx, [I]
     Read registers V0 through Vx from memory starting at location I.
 
     The interpreter reads values from memory starting at location I into registers V0 through Vx.
 */
+template<uint8_t X>
 void
 Processor::Chip8::fx_ld_vx_i()
 {
-  std::cout << "fx_ld_vx_i: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("fx_ld_vx_i");
 
-  for (int i = 0; i <= (MASK(0x0F00) >> 8); ++i)
+  for (int i = 0; i <= X; ++i)
   {
-    this->registers[i] = this->memory[this->indexRegister + i];
+    this->registers[i] = this->memory[(this->indexRegister + i) & 0xFFF];
   }
-  this->indexRegister += (MASK(0x0F00) >> 8) + 1;
+  this->indexRegister += X + 1;
   this->programCounter += 2;
 }
 
@@ -420,12 +1540,13 @@ Processor::Chip8::fx_ld_vx_i()
 
     The value of I is set to the location for the hexadecimal sprite corresponding to the value of Vx
 */
+template<uint8_t X>
 void
 Processor::Chip8::fx_ld_f_vx()
 {
-  std::cout << "fx_ld_f_vx: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("fx_ld_f_vx");
 
-  this->indexRegister = this->registers[(this->opCode & 0x0F00) >> 8] * 0x5;
+  this->indexRegister = this->registers[X] * 0x5;
   this->programCounter += 2;
 }
 
@@ -435,17 +1556,20 @@ Processor::Chip8::fx_ld_f_vx()
 
     The values of I and Vx are added, and the results are stored in I.
 */
+template<uint8_t X>
 void
 Processor::Chip8::fx_add_i_vx()
 {
-  std::cout << "fx_add_i_vx: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("fx_add_i_vx");
   // VF is set to 1 when range overflow (I+VX>0xFFF), and 0
+  // Vx as it was before VF changes, X may be F
+  uint8_t value = this->registers[X];
   this->registers[0xF] = 0;
-  if ( (this->indexRegister + this->registers[MASK(0x0F00) >> 8]) > 0xFFF )
+  if ( (this->indexRegister + value) > 0xFFF )
   {
     this->registers[0xF] = 1;
   }
-  this->indexRegister += this->registers[MASK(0x0F00) >> 8];
+  this->indexRegister += value;
   this->programCounter += 2;
 }
 
@@ -455,12 +1579,13 @@ Processor::Chip8::fx_add_i_vx()
     Set Vx = Vx + kk.
     Adds the value kk to the value of register Vx, then stores the result in Vx. 
 */
+template<uint8_t X>
 void
 Processor::Chip8::add_vx_byte()
 {
-  std::cout << "add_vx_byte: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("add_vx_byte");
 
-  this->registers[MASK(0x0F00) >> 8] += MASK(0x00FF);
+  this->registers[X] += this->instruction->kk;
   this->programCounter += 2;
 }
 
@@ -471,12 +1596,13 @@ Processor::Chip8::add_vx_byte()
     The interpreter generates a random number from 0 to 255, which is then ANDed with the value kk. T
     he results are stored in Vx.
 */
+template<uint8_t X>
 void
 Processor::Chip8::rnd_vx_byte()
 {
-  std::cout << "rnd_vx_byte: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("rnd_vx_byte");
 
-  this->registers[(this->opCode & 0x0F00 ) >> 8] = (rand() % (0xFF + 1)) & (this->opCode & 0x00FF);
+  this->registers[X] = (nextRandom(this->random) % (0xFF + 1)) & this->instruction->kk;
   this->programCounter += 2;
 }
 
@@ -494,16 +1620,17 @@ Processor::Chip8::rnd_vx_byte()
       Checks the keyboard, and if the key corresponding to the value of Vx is currently in the up position, 
       PC is increased by 2.
 */
+template<uint8_t X, uint8_t KK>
 void
 Processor::Chip8::ex_skip()
 {
-  std::cout << "ex_skip: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("ex_skip");
 
-  switch( this->opCode & 0x00FF)
+  switch( KK )
   {
 
     case 0x009E:
-      if ( this->key[( this->registers[MASK(0x0F00) >> 8 ] )] != 0)
+      if ( this->key[( this->registers[X] & 0xF )] != 0)
       {
         this->programCounter += 4;
       }
@@ -513,7 +1640,7 @@ Processor::Chip8::ex_skip()
       }
       break;
     case 0x00A1:
-      if ( this->key[ (this->registers[MASK(0x0F00) >> 8 ]) ] == 0)
+      if ( this->key[ (this->registers[X] & 0xF) ] == 0)
       {
         this->programCounter += 4;
       }
@@ -523,8 +1650,8 @@ Processor::Chip8::ex_skip()
       }
       break;
     default:
-      std::cout << "Unimplemented EX OpCode: " << hexdump(this->opCode) << std::endl;
-      exit(1);
+      std::cerr << "Unimplemented EX OpCode: " << hexdump(this->opCode) << std::endl;
+      this->halted = true;
 
   }
 }
@@ -591,38 +1718,39 @@ Processor::Chip8::ex_skip()
     If the most-significant bit of Vx is 1, then VF is set to 1, otherwise to 0. Then Vx is multiplied by 2.
 */
 
+template<uint8_t X, uint8_t Y, uint8_t N>
 void
 Processor::Chip8::register_vx_vy_byte()
 {
-  std::cout << "register_vx_vy_byte: " << hexdump(this->opCode) << std::endl;
+  C8_TRACE("register_vx_vy_byte");
 
-  switch (MASK(0x000F))
+  switch (N)
   {
 
     case 0x0000:
-      this->registers[MASK(0x0F00) >> 8] = this->registers[MASK(0x00F0) >> 4];
+      this->registers[X] = this->registers[Y];
       this->programCounter += 2;
       break;
 
     case 0x0001:
-      this->registers[MASK(0x0F00) >> 8] |= this->registers[MASK(0x00F0) >> 4];
+      this->registers[X] |= this->registers[Y];
       this->programCounter += 2;
       break;
 
     case 0x0002:
-      this->registers[MASK(0x0F00) >> 8] &= this->registers[MASK(0x00F0) >> 4];
+      this->registers[X] &= this->registers[Y];
       this->programCounter += 2;
       break;
 
     case 0x0003:
-      this->registers[MASK(0x0F00) >> 8] ^= this->registers[MASK(0x00F0) >> 4];
+      this->registers[X] ^= this->registers[Y];
       this->programCounter += 2;
       break;
 
     case 0x0004:
-      this->registers[MASK(0x0F00) >> 8] += this->registers[MASK(0x00F0) >> 4];
+      this->registers[X] += this->registers[Y];
       this->registers[0xF] = 0;
-      if (this->registers[MASK(0x00F0) >> 4] > (0xFF - this->registers[MASK(0x0F00) >> 8] ))
+      if (this->registers[Y] > (0xFF - this->registers[X] ))
       {
         // carry flag
         this->registers[0xF] = 1;
@@ -632,39 +1760,39 @@ Processor::Chip8::register_vx_vy_byte()
 
     case 0x0005:
       this->registers[0xF] = 1; // no borrow
-      if ( this->registers[MASK(0x00F0) >> 4] > this->registers[MASK(0x0F00) >> 8] )
+      if ( this->registers[Y] > this->registers[X] )
       {
         this->registers[0xF] = 0; // there is a borrow
       }
-      this->registers[MASK(0x0F00) >> 8] -= this->registers[MASK(0x00F0) >> 4];
+      this->registers[X] -= this->registers[Y];
       this->programCounter += 2;
       break;
 
     case 0x0006:
-      this->registers[0xF] = this->registers[MASK(0x0F00) >> 8] & 0x1;
-      this->registers[MASK(0x0F00) >> 8] >>= 1;
+      this->registers[0xF] = this->registers[X] & 0x1;
+      this->registers[X] >>= 1;
       this->programCounter += 2;
       break;
 
     case 0x0007:
       this->registers[0xF] = 1; // no borrow
-      if ( this->registers[MASK(0x0F00) >> 8] > this->registers[MASK(0x00F0) >> 4] )
+      if ( this->registers[X] > this->registers[Y] )
       {
         this->registers[0xF] = 0; // borrow
       }
-      this->registers[MASK(0x0F00) >> 8] = this->registers[MASK(0x00F0) >> 4] - this->registers[MASK(0x0F00) >> 8];
+      this->registers[X] = this->registers[Y] - this->registers[X];
       this->programCounter += 2;
       break;
 
     case 0x000E:
-      this->registers[0xF] = this->registers[MASK(0x0F00) >> 8] >> 7;
-      this->registers[MASK(0x0F00) >> 8] <<= 1;
+      this->registers[0xF] = this->registers[X] >> 7;
+      this->registers[X] <<= 1;
       this->programCounter += 2;
       break;
 
     default:
-      std::cout << "Unimplemented register_vx_vy_byte OpCode: " << hexdump(this->opCode) << std::endl;
-      exit(1);
+      std::cerr << "Unimplemented register_vx_vy_byte OpCode: " << hexdump(this->opCode) << std::endl;
+      this->halted = true;
   }
 
 }
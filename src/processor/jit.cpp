@@ -0,0 +1,711 @@
+#include "processor/jit.hpp"
+
+#ifdef C8_JIT_SUPPORTED
+
+#include <stddef.h>
+#include <sys/mman.h>
+
+// host registers
+#define RAX 0
+#define RCX 1
+#define RDX 2
+#define RBX 3
+#define RSP 4
+#define RBP 5
+#define RSI 6
+#define RDI 7
+#define R8  8
+#define R9  9
+#define R10 10
+#define R11 11
+#define R12 12
+#define R13 13
+#define R14 14
+#define R15 15
+
+// register to register opcodes (op r/m32, r32)
+#define X86_ADD 0x01
+#define X86_OR  0x09
+#define X86_AND 0x21
+#define X86_SUB 0x29
+#define X86_XOR 0x31
+#define X86_CMP 0x39
+#define X86_MOV 0x89
+
+// /digit extensions of 0x81 (op r/m32, imm32), 0xC1 (shift r/m32, imm8)
+#define EXT_ADD 0
+#define EXT_ADC 2
+#define EXT_SBB 3
+#define EXT_AND 4
+#define EXT_SUB 5
+#define EXT_CMP 7
+#define EXT_SHL 4
+#define EXT_SHR 5
+
+// condition codes
+#define CC_E  0x4
+#define CC_NE 0x5
+#define CC_L  0xC
+
+// JitContext offsets used by compiled code
+#define CTX_V        offsetof(Processor::JitContext, V)
+#define CTX_I        offsetof(Processor::JitContext, I)
+#define CTX_PC       offsetof(Processor::JitContext, pc)
+#define CTX_BUDGET   offsetof(Processor::JitContext, budget)
+#define CTX_EXECUTED offsetof(Processor::JitContext, executed)
+
+// host registers guest registers can live in: everything but rax/rcx (scratch), rsp and rdi (context)
+static const int hostRegisters[] = { RDX, RBX, RBP, RSI, R8, R9, R10, R11, R12, R13, R14, R15 };
+static const int hostRegisterCount = sizeof(hostRegisters) / sizeof(hostRegisters[0]);
+
+typedef void (*jitEnter)(Processor::JitContext *context, const uint8_t *code);
+
+/*
+  Which guest registers an operation reads or writes, and which it writes.
+  Returns false for operations the recompiler leaves to the interpreter.
+*/
+static bool
+guestRegisters(const Processor::Chip8::Instruction *op, bool *used, bool *written)
+{
+  switch (op->operation)
+  {
+    case Processor::OP_JP_ADDR:
+      return true;
+
+    case Processor::OP_SE_VX_BYTE:
+    case Processor::OP_SNE_VX_BYTE:
+      used[op->x] = true;
+      return true;
+
+    case Processor::OP_LD_VX_BYTE:
+    case Processor::OP_ADD_VX_BYTE:
+      used[op->x] = written[op->x] = true;
+      return true;
+
+    case Processor::OP_LD_VX_VY:
+    case Processor::OP_OR_VX_VY:
+    case Processor::OP_AND_VX_VY:
+    case Processor::OP_XOR_VX_VY:
+      used[op->x] = written[op->x] = true;
+      used[op->y] = true;
+      return true;
+
+    case Processor::OP_ADD_VX_VY:
+    case Processor::OP_SUB_VX_VY:
+    case Processor::OP_SUBN_VX_VY:
+      used[op->x] = written[op->x] = true;
+      used[op->y] = true;
+      used[0xF] = written[0xF] = true;
+      return true;
+
+    case Processor::OP_SHR_VX:
+    case Processor::OP_SHL_VX:
+      used[op->x] = written[op->x] = true;
+      used[0xF] = written[0xF] = true;
+      return true;
+
+    case Processor::OP_LD_I_ADDR:
+      used[C8_JIT_GUEST_I] = written[C8_JIT_GUEST_I] = true;
+      return true;
+
+    case Processor::OP_ADD_I_VX:
+      used[C8_JIT_GUEST_I] = written[C8_JIT_GUEST_I] = true;
+      used[op->x] = true;
+      used[0xF] = written[0xF] = true;
+      return true;
+
+    case Processor::OP_LD_F_VX:
+      used[C8_JIT_GUEST_I] = written[C8_JIT_GUEST_I] = true;
+      used[op->x] = true;
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+static bool
+endsBlock(uint8_t operation)
+{
+  return operation == Processor::OP_JP_ADDR
+    || operation == Processor::OP_SE_VX_BYTE
+    || operation == Processor::OP_SNE_VX_BYTE;
+}
+
+Processor::Jit::Jit()
+{
+  this->buffer = (uint8_t *)mmap(NULL, C8_JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if ( this->buffer == MAP_FAILED )
+  {
+    this->buffer = NULL;
+    return;
+  }
+
+  this->used = 0;
+
+  // enter(context: rdi, code: rsi) - save the callee-saved registers blocks use and jump in
+  this->emit(0x53);                         // push rbx
+  this->emit(0x55);                         // push rbp
+  this->emit(0x41); this->emit(0x54);       // push r12
+  this->emit(0x41); this->emit(0x55);       // push r13
+  this->emit(0x41); this->emit(0x56);       // push r14
+  this->emit(0x41); this->emit(0x57);       // push r15
+  this->emit(0xFF); this->emit(0xE6);       // jmp rsi
+
+  this->exitCode = this->buffer + this->used;
+  this->emit(0x41); this->emit(0x5F);       // pop r15
+  this->emit(0x41); this->emit(0x5E);       // pop r14
+  this->emit(0x41); this->emit(0x5D);       // pop r13
+  this->emit(0x41); this->emit(0x5C);       // pop r12
+  this->emit(0x5D);                         // pop rbp
+  this->emit(0x5B);                         // pop rbx
+  this->emit(0xC3);                         // ret
+
+  this->codeStart = this->used;
+  this->flush();
+}
+
+Processor::Jit::~Jit()
+{
+  if ( this->buffer != NULL )
+  {
+    munmap(this->buffer, C8_JIT_BUFFER_SIZE);
+  }
+}
+
+bool
+Processor::Jit::ready() const
+{
+  return this->buffer != NULL;
+}
+
+void
+Processor::Jit::flush()
+{
+  this->used = this->codeStart;
+  this->links.clear();
+  for (int i = 0; i < 4096; ++i)
+  {
+    this->blockAt[i] = NULL;
+    this->uncompilable[i] = false;
+    this->covered[i] = false;
+  }
+}
+
+/*
+  Returns compiled code for the guest address, compiling it on first use.
+  NULL means the instruction there has to be interpreted.
+*/
+const uint8_t *
+Processor::Jit::lookup(uint16_t address, const uint8_t *memory, const Chip8::Instruction *decodeTable)
+{
+  if ( address + 1 >= 4096 || this->uncompilable[address] )
+  {
+    return NULL;
+  }
+  if ( this->blockAt[address] != NULL )
+  {
+    return this->blockAt[address];
+  }
+  return this->compile(address, memory, decodeTable);
+}
+
+void
+Processor::Jit::enter(JitContext *context, const uint8_t *code)
+{
+  jitEnter entry = reinterpret_cast<jitEnter>(this->buffer);
+  entry(context, code);
+}
+
+/*
+  Compiled code is discarded as a whole when memory it was built from changes;
+  chained blocks jump straight into each other, so none of it can be kept.
+*/
+void
+Processor::Jit::invalidate(uint16_t address, uint16_t length)
+{
+  for (uint32_t i = address; i < (uint32_t)address + length && i < 4096; ++i)
+  {
+    if ( this->covered[i] )
+    {
+      this->flush();
+      return;
+    }
+  }
+}
+
+uint8_t *
+Processor::Jit::compile(uint16_t address, const uint8_t *memory, const Chip8::Instruction *decodeTable)
+{
+  const Chip8::Instruction *ops[C8_JIT_MAX_OPS];
+  bool used[17] = { false };
+  bool dirty[17] = { false };
+  int  length = 0;
+  int  allocated = 0;
+
+  // the instruction at 0xFFF wraps around to 0x000, it is left to the interpreter
+  uint16_t pc = address;
+  while ( pc + 1 < 4096 && length < C8_JIT_MAX_OPS )
+  {
+    const Chip8::Instruction *op = &decodeTable[memory[pc] << 8 | memory[pc + 1]];
+
+    bool opUsed[17] = { false };
+    bool opWritten[17] = { false };
+    if ( !guestRegisters(op, opUsed, opWritten) )
+    {
+      break;
+    }
+
+    // stop before running out of host registers
+    int needed = allocated;
+    for (int g = 0; g < 17; ++g)
+    {
+      if ( opUsed[g] && !used[g] )
+      {
+        ++needed;
+      }
+    }
+    if ( needed > hostRegisterCount )
+    {
+      break;
+    }
+
+    for (int g = 0; g < 17; ++g)
+    {
+      used[g] = used[g] || opUsed[g];
+      dirty[g] = dirty[g] || opWritten[g];
+    }
+    allocated = needed;
+    ops[length++] = op;
+    pc += 2;
+
+    if ( endsBlock(op->operation) )
+    {
+      break;
+    }
+  }
+
+  if ( length == 0 )
+  {
+    this->uncompilable[address] = true;
+    this->covered[address] = true;
+    this->covered[address + 1] = true;
+    return NULL;
+  }
+
+  if ( C8_JIT_BUFFER_SIZE - this->used < C8_JIT_BLOCK_SPACE )
+  {
+    this->flush();
+  }
+
+  int8_t host[17];
+  int next = 0;
+  for (int g = 0; g < 17; ++g)
+  {
+    host[g] = used[g] ? hostRegisters[next++] : -1;
+  }
+
+  uint8_t *entry = this->buffer + this->used;
+
+  // not enough budget left for the whole block: let the interpreter take this one
+  this->aluMemImm(EXT_CMP, CTX_BUDGET, length);
+  size_t bail = this->jumpIf(CC_L);
+
+  for (int g = 0; g < 16; ++g)
+  {
+    if ( host[g] >= 0 )
+    {
+      this->loadByte(host[g], CTX_V + g);
+    }
+  }
+  if ( host[C8_JIT_GUEST_I] >= 0 )
+  {
+    this->loadWord(host[C8_JIT_GUEST_I], CTX_I);
+  }
+
+  bool closed = false;
+  for (int i = 0; i < length; ++i)
+  {
+    const Chip8::Instruction *op = ops[i];
+    uint16_t opAddress = address + i * 2;
+    int X = host[op->x];
+    int Y = host[op->y];
+    int F = host[0xF];
+    int I = host[C8_JIT_GUEST_I];
+
+    switch (op->operation)
+    {
+      case OP_LD_VX_BYTE:
+        this->movRegImm(X, op->kk);
+        break;
+
+      case OP_ADD_VX_BYTE:
+        this->aluRegImm(EXT_ADD, X, op->kk);
+        this->aluRegImm(EXT_AND, X, 0xFF);
+        break;
+
+      case OP_LD_VX_VY:
+        this->aluRegReg(X86_MOV, X, Y);
+        break;
+
+      case OP_OR_VX_VY:
+        this->aluRegReg(X86_OR, X, Y);
+        break;
+
+      case OP_AND_VX_VY:
+        this->aluRegReg(X86_AND, X, Y);
+        break;
+
+      case OP_XOR_VX_VY:
+        this->aluRegReg(X86_XOR, X, Y);
+        break;
+
+      // Vx += Vy, VF = 0, VF = 1 if Vy > 0xFF - Vx
+      case OP_ADD_VX_VY:
+        this->aluRegReg(X86_ADD, X, Y);
+        this->aluRegImm(EXT_AND, X, 0xFF);
+        this->movRegImm(F, 0);
+        this->movRegImm(RAX, 0xFF);
+        this->aluRegReg(X86_SUB, RAX, X);
+        this->aluRegReg(X86_CMP, RAX, Y);         // carry when Vy > 0xFF - Vx
+        this->aluRegImm(EXT_ADC, F, 0);
+        break;
+
+      // VF = 1, VF = 0 if Vy > Vx, Vx -= Vy
+      case OP_SUB_VX_VY:
+        this->movRegImm(F, 1);
+        this->aluRegReg(X86_CMP, X, Y);           // carry when Vx < Vy
+        this->aluRegImm(EXT_SBB, F, 0);
+        this->aluRegReg(X86_SUB, X, Y);
+        this->aluRegImm(EXT_AND, X, 0xFF);
+        break;
+
+      // VF = Vx & 1, Vx >>= 1
+      case OP_SHR_VX:
+        this->aluRegReg(X86_MOV, RAX, X);
+        this->aluRegImm(EXT_AND, RAX, 0x1);
+        this->aluRegReg(X86_MOV, F, RAX);
+        this->shiftRegImm(EXT_SHR, X, 1);
+        break;
+
+      // VF = 1, VF = 0 if Vx > Vy, Vx = Vy - Vx
+      case OP_SUBN_VX_VY:
+        this->movRegImm(F, 1);
+        this->aluRegReg(X86_CMP, Y, X);           // carry when Vy < Vx
+        this->aluRegImm(EXT_SBB, F, 0);
+        this->aluRegReg(X86_MOV, RAX, Y);
+        this->aluRegReg(X86_SUB, RAX, X);
+        this->aluRegImm(EXT_AND, RAX, 0xFF);
+        this->aluRegReg(X86_MOV, X, RAX);
+        break;
+
+      // VF = Vx >> 7, Vx <<= 1
+      case OP_SHL_VX:
+        this->aluRegReg(X86_MOV, RAX, X);
+        this->shiftRegImm(EXT_SHR, RAX, 7);
+        this->aluRegReg(X86_MOV, F, RAX);
+        this->shiftRegImm(EXT_SHL, X, 1);
+        this->aluRegImm(EXT_AND, X, 0xFF);
+        break;
+
+      case OP_LD_I_ADDR:
+        this->movRegImm(I, op->nnn);
+        break;
+
+      // VF = 0, VF = 1 if I + Vx > 0xFFF, I += Vx
+      case OP_ADD_I_VX:
+        this->aluRegReg(X86_MOV, RCX, X);         // Vx before VF changes, x may be F
+        this->aluRegReg(X86_MOV, RAX, I);
+        this->aluRegReg(X86_ADD, RAX, RCX);
+        this->aluRegImm(EXT_CMP, RAX, 0x1000);    // carry when I + Vx <= 0xFFF
+        this->movRegImm(F, 1);
+        this->aluRegImm(EXT_SBB, F, 0);
+        this->aluRegReg(X86_ADD, I, RCX);
+        this->aluRegImm(EXT_AND, I, 0xFFFF);
+        break;
+
+      case OP_LD_F_VX:
+        this->imulRegRegImm(I, X, 5);
+        break;
+
+      case OP_JP_ADDR:
+        this->emitExit(op->nnn, i + 1, host, dirty);
+        closed = true;
+        break;
+
+      case OP_SE_VX_BYTE:
+      case OP_SNE_VX_BYTE:
+      {
+        this->aluRegImm(EXT_CMP, X, op->kk);
+        size_t noSkip = this->jumpIf(op->operation == OP_SE_VX_BYTE ? CC_NE : CC_E);
+        this->emitExit(opAddress + 4, i + 1, host, dirty);
+        this->patch(noSkip, this->buffer + this->used);
+        this->emitExit(opAddress + 2, i + 1, host, dirty);
+        closed = true;
+        break;
+      }
+    }
+  }
+
+  if ( !closed )
+  {
+    this->emitExit(pc, length, host, dirty);
+  }
+
+  this->patch(bail, this->buffer + this->used);
+  this->storeWordImm(CTX_PC, address);
+  this->patch(this->jump(), this->exitCode);
+
+  for (uint16_t i = address; i < pc; ++i)
+  {
+    this->covered[i] = true;
+  }
+  this->blockAt[address] = entry;
+
+  // chain every exit that was waiting on this address
+  for (size_t i = 0; i < this->links.size(); )
+  {
+    if ( this->links[i].target == address )
+    {
+      this->patch(this->links[i].at, entry);
+      this->links[i] = this->links.back();
+      this->links.pop_back();
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  return entry;
+}
+
+/*
+  Writes back dirty guest registers, accounts for the instructions executed
+  on this path and continues at `target`: directly in its compiled block when
+  there is one, otherwise back to the host.
+*/
+void
+Processor::Jit::emitExit(uint16_t target, uint32_t executed, const int8_t *host, const bool *dirty)
+{
+  for (int g = 0; g < 16; ++g)
+  {
+    if ( dirty[g] )
+    {
+      this->storeByte(CTX_V + g, host[g]);
+    }
+  }
+  if ( dirty[C8_JIT_GUEST_I] )
+  {
+    this->storeWord(CTX_I, host[C8_JIT_GUEST_I]);
+  }
+
+  this->aluMemImm(EXT_ADD, CTX_EXECUTED, executed);
+  this->aluMemImm(EXT_SUB, CTX_BUDGET, executed);
+  size_t link = this->jump();
+
+  uint8_t *toHost = this->buffer + this->used;
+  this->storeWordImm(CTX_PC, target);
+  this->patch(this->jump(), this->exitCode);
+
+  if ( target < 4096 && this->blockAt[target] != NULL )
+  {
+    this->patch(link, this->blockAt[target]);
+  }
+  else
+  {
+    this->patch(link, toHost);
+    Link pending = { link, target };
+    this->links.push_back(pending);
+  }
+}
+
+void
+Processor::Jit::patch(size_t at, const uint8_t *target)
+{
+  int32_t relative = (int32_t)(target - (this->buffer + at + 4));
+  memcpy(this->buffer + at, &relative, 4);
+}
+
+/*
+  x86-64 encoding
+*/
+
+void
+Processor::Jit::emit(uint8_t byte)
+{
+  this->buffer[this->used++] = byte;
+}
+
+void
+Processor::Jit::emit16(uint16_t value)
+{
+  memcpy(this->buffer + this->used, &value, 2);
+  this->used += 2;
+}
+
+void
+Processor::Jit::emit32(uint32_t value)
+{
+  memcpy(this->buffer + this->used, &value, 4);
+  this->used += 4;
+}
+
+// REX prefix for 32-bit operands, forced when byte registers above bl are used
+void
+Processor::Jit::rex(int reg, int rm, bool force)
+{
+  uint8_t prefix = 0x40 | ((reg & 8) ? 0x4 : 0) | ((rm & 8) ? 0x1 : 0);
+  if ( prefix != 0x40 || force )
+  {
+    this->emit(prefix);
+  }
+}
+
+// mov r32, imm32
+void
+Processor::Jit::movRegImm(int reg, uint32_t value)
+{
+  this->rex(0, reg, false);
+  this->emit(0xB8 + (reg & 7));
+  this->emit32(value);
+}
+
+// op r/m32, r32
+void
+Processor::Jit::aluRegReg(uint8_t opcode, int dst, int src)
+{
+  this->rex(src, dst, false);
+  this->emit(opcode);
+  this->emit(0xC0 | ((src & 7) << 3) | (dst & 7));
+}
+
+// op r/m32, imm32
+void
+Processor::Jit::aluRegImm(uint8_t extension, int reg, uint32_t value)
+{
+  this->rex(0, reg, false);
+  this->emit(0x81);
+  this->emit(0xC0 | (extension << 3) | (reg & 7));
+  this->emit32(value);
+}
+
+// op dword [rdi + offset], imm32
+void
+Processor::Jit::aluMemImm(uint8_t extension, uint8_t offset, uint32_t value)
+{
+  this->emit(0x81);
+  this->emit(0x47 | (extension << 3));
+  this->emit(offset);
+  this->emit32(value);
+}
+
+// shl/shr r32, imm8
+void
+Processor::Jit::shiftRegImm(uint8_t extension, int reg, uint8_t count)
+{
+  this->rex(0, reg, false);
+  this->emit(0xC1);
+  this->emit(0xC0 | (extension << 3) | (reg & 7));
+  this->emit(count);
+}
+
+// imul r32, r/m32, imm8
+void
+Processor::Jit::imulRegRegImm(int dst, int src, int8_t value)
+{
+  this->rex(dst, src, false);
+  this->emit(0x6B);
+  this->emit(0xC0 | ((dst & 7) << 3) | (src & 7));
+  this->emit(value);
+}
+
+// movzx r32, byte [rdi + offset]
+void
+Processor::Jit::loadByte(int reg, uint8_t offset)
+{
+  this->rex(reg, 0, false);
+  this->emit(0x0F);
+  this->emit(0xB6);
+  this->emit(0x47 | ((reg & 7) << 3));
+  this->emit(offset);
+}
+
+// movzx r32, word [rdi + offset]
+void
+Processor::Jit::loadWord(int reg, uint8_t offset)
+{
+  this->rex(reg, 0, false);
+  this->emit(0x0F);
+  this->emit(0xB7);
+  this->emit(0x47 | ((reg & 7) << 3));
+  this->emit(offset);
+}
+
+// mov byte [rdi + offset], r8
+void
+Processor::Jit::storeByte(uint8_t offset, int reg)
+{
+  this->rex(reg, 0, true);
+  this->emit(0x88);
+  this->emit(0x47 | ((reg & 7) << 3));
+  this->emit(offset);
+}
+
+// mov word [rdi + offset], r16
+void
+Processor::Jit::storeWord(uint8_t offset, int reg)
+{
+  this->emit(0x66);
+  this->rex(reg, 0, false);
+  this->emit(0x89);
+  this->emit(0x47 | ((reg & 7) << 3));
+  this->emit(offset);
+}
+
+// mov word [rdi + offset], imm16
+void
+Processor::Jit::storeWordImm(uint8_t offset, uint16_t value)
+{
+  this->emit(0x66);
+  this->emit(0xC7);
+  this->emit(0x47);
+  this->emit(offset);
+  this->emit16(value);
+}
+
+// jmp rel32, returns where to patch the displacement
+size_t
+Processor::Jit::jump()
+{
+  this->emit(0xE9);
+  this->emit32(0);
+  return this->used - 4;
+}
+
+// jcc rel32, returns where to patch the displacement
+size_t
+Processor::Jit::jumpIf(uint8_t condition)
+{
+  this->emit(0x0F);
+  this->emit(0x80 | condition);
+  this->emit32(0);
+  return this->used - 4;
+}
+
+#else
+
+/*
+  No recompiler for this host, ready() stays false and the processor keeps
+  interpreting.
+*/
+Processor::Jit::Jit() : buffer(NULL) {}
+Processor::Jit::~Jit() {}
+bool Processor::Jit::ready() const { return false; }
+const uint8_t *Processor::Jit::lookup(uint16_t, const uint8_t *, const Chip8::Instruction *) { return NULL; }
+void Processor::Jit::enter(JitContext *, const uint8_t *) {}
+void Processor::Jit::invalidate(uint16_t, uint16_t) {}
+void Processor::Jit::flush() {}
+
+#endif
@@ -0,0 +1,458 @@
+#include "processor/lanes.hpp"
+
+// runs over every lane, `lane` is in scope
+#define C8_LANES for (int lane = 0; lane < N; ++lane)
+
+// target = value in the lanes taking part in the current instruction. Written
+// as a select rather than a branch so the loop compiles to vector blends.
+#define C8_SELECT(target, value) C8_LANES { target = this->active[lane] ? (value) : (target); }
+
+// the same, for work that can't be vectorized
+#define C8_EACH_ACTIVE C8_LANES if ( this->active[lane] )
+
+template<int N>
+Processor::Lanes<N>::Lanes(const char *file_path)
+{
+  // every lane starts from the same image a Chip8 would load
+  Chip8 image(file_path);
+  image.initialize();
+
+  for (int lane = 0; lane < N; ++lane)
+  {
+    memcpy(this->memory[lane], image.memory, sizeof(image.memory));
+    memset(this->graphicsBuffer[lane], 0, sizeof(this->graphicsBuffer[lane]));
+    memset(this->key[lane], 0, sizeof(this->key[lane]));
+    this->I[lane] = 0;
+    this->pc[lane] = C8_MEMORY_OFFSET_HEX;
+    this->sp[lane] = 0;
+    this->delayExpires[lane] = 0;
+    this->soundExpires[lane] = 0;
+    this->keyWait[lane] = 0;
+    this->keyHeld[lane] = C8_NO_KEY;
+    this->drawFlag[lane] = false;
+    this->beepFlag[lane] = false;
+    this->halted[lane] = false;
+    this->instructions[lane] = 0;
+    seedRandom(this->random[lane], time(NULL));
+    for (int i = 0; i < 16; ++i)
+    {
+      this->V[i][lane] = 0;
+      this->stack[i][lane] = 0;
+    }
+  }
+}
+
+template<int N>
+void
+Processor::Lanes<N>::seed(int lane, uint32_t value)
+{
+  seedRandom(this->random[lane], value);
+}
+
+/*
+  Chip8::press() for one lane
+*/
+template<int N>
+void
+Processor::Lanes<N>::press(int lane, uint8_t key, bool down)
+{
+  this->key[lane][key & 0xF] = down ? 1 : 0;
+  if ( down && this->keyWait[lane] != 0 && this->keyHeld[lane] == C8_NO_KEY )
+  {
+    this->keyHeld[lane] = key & 0xF;
+  }
+}
+
+/*
+  Chip8::awaitKey() for one lane, true while it is still blocked on Fx0A
+*/
+template<int N>
+bool
+Processor::Lanes<N>::awaitKey(int lane)
+{
+  if ( this->keyWait[lane] == 0 )
+  {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < 16 && this->keyHeld[lane] == C8_NO_KEY; ++i)
+  {
+    if ( this->key[lane][i] != 0 )
+    {
+      this->keyHeld[lane] = i;
+    }
+  }
+
+  uint8_t held = this->keyHeld[lane];
+  if ( held == C8_NO_KEY || this->key[lane][held] != 0 )
+  {
+    return true;
+  }
+
+  this->V[this->keyWait[lane] & 0xF][lane] = held;
+  this->keyWait[lane] = 0;
+  this->keyHeld[lane] = C8_NO_KEY;
+  this->pc[lane] += 2;
+  return false;
+}
+
+/*
+  Every running lane executes `cycles` instructions, lanes that halt stop
+  early and lanes blocked on Fx0A idle through the rest. Unlike Chip8::run()
+  drawing doesn't end the run, check drawFlag afterwards. Returns the
+  instructions executed over all lanes.
+*/
+template<int N>
+uint64_t
+Processor::Lanes<N>::run(uint32_t cycles)
+{
+  uint64_t executed = 0;
+  C8_LANES
+  {
+    this->remaining[lane] = this->halted[lane] ? 0 : cycles;
+    if ( this->remaining[lane] > 0 && this->awaitKey(lane) )
+    {
+      this->instructions[lane] += cycles;
+      executed += cycles;
+      this->remaining[lane] = 0;
+    }
+  }
+
+  while (true)
+  {
+    // reconverge on the lowest program counter still running
+    uint32_t lowest = 0x10000;
+    C8_LANES
+    {
+      uint32_t candidate = this->remaining[lane] > 0 ? this->pc[lane] : 0x10000;
+      lowest = candidate < lowest ? candidate : lowest;
+    }
+    if ( lowest == 0x10000 )
+    {
+      break;
+    }
+
+    int leader = 0;
+    while ( this->remaining[leader] == 0 || this->pc[leader] != lowest )
+    {
+      ++leader;
+    }
+
+    uint16_t address = lowest;
+    const uint8_t *code = this->memory[leader];
+    uint16_t opCode = code[address & 0xFFF] << 8 | code[(address + 1) & 0xFFF];
+
+    C8_LANES
+    {
+      this->active[lane] = this->remaining[lane] > 0
+        && this->pc[lane] == address
+        && this->memory[lane][address & 0xFFF] == code[address & 0xFFF]
+        && this->memory[lane][(address + 1) & 0xFFF] == code[(address + 1) & 0xFFF];
+    }
+
+    this->execute(Chip8::decodeTable[opCode]);
+
+    // halting lanes leave the run without executing or ticking
+    C8_LANES
+    {
+      this->active[lane] = this->active[lane] && !this->halted[lane];
+      this->remaining[lane] = this->halted[lane] ? 0 : this->remaining[lane] - this->active[lane];
+      this->instructions[lane] += this->active[lane];
+      executed += this->active[lane];
+    }
+
+    // lanes that just blocked on Fx0A spend the rest of the run waiting, as Chip8::run() does
+    if ( Chip8::decodeTable[opCode].operation == OP_LD_VX_K )
+    {
+      C8_LANES
+      {
+        if ( this->remaining[lane] > 0 && this->awaitKey(lane) )
+        {
+          this->instructions[lane] += this->remaining[lane];
+          executed += this->remaining[lane];
+          this->remaining[lane] = 0;
+        }
+      }
+    }
+  }
+
+  C8_LANES
+  {
+    this->settleSound(lane);
+  }
+  return executed;
+}
+
+/*
+  Timers as Chip8State keeps them: the frame of a lane's own clock they run
+  out in, counted down only when read
+*/
+template<int N>
+uint8_t
+Processor::Lanes<N>::timer(uint64_t expires, int lane) const
+{
+  uint64_t now = this->frame(lane);
+  return expires > now ? expires - now : 0;
+}
+
+template<int N>
+void
+Processor::Lanes<N>::settleSound(int lane)
+{
+  if ( this->soundExpires[lane] != 0 && this->frame(lane) >= this->soundExpires[lane] )
+  {
+    // BEEP!
+    this->beepFlag[lane] = true;
+    this->soundExpires[lane] = 0;
+  }
+}
+
+/*
+  One instruction in every active lane. Statements mirror the handlers in
+  chip8.cpp one for one and in the same order, so lanes stay bit-exact
+  with it even where registers alias (x or y being F).
+*/
+template<int N>
+void
+Processor::Lanes<N>::execute(const Chip8::Instruction &op)
+{
+  uint8_t *Vx = this->V[op.x];
+  uint8_t *Vy = this->V[op.y];
+  uint8_t *VF = this->V[0xF];
+
+  switch (op.operation)
+  {
+    case OP_CLS:
+      C8_EACH_ACTIVE
+      {
+        memset(this->graphicsBuffer[lane], 0, sizeof(this->graphicsBuffer[lane]));
+        this->drawFlag[lane] = true;
+      }
+      break;
+
+    case OP_RET:
+      C8_EACH_ACTIVE
+      {
+        --this->sp[lane];
+        this->pc[lane] = this->stack[this->sp[lane] & 0xF][lane];
+      }
+      break;
+
+    case OP_JP_ADDR:
+      C8_SELECT(this->pc[lane], op.nnn);
+      return;
+
+    case OP_CALL_ADDR:
+      C8_EACH_ACTIVE
+      {
+        this->stack[this->sp[lane] & 0xF][lane] = this->pc[lane];
+        ++this->sp[lane];
+        this->pc[lane] = op.nnn;
+      }
+      return;
+
+    case OP_SE_VX_BYTE:
+      C8_SELECT(this->pc[lane], this->pc[lane] + (Vx[lane] == op.kk ? 4 : 2));
+      return;
+
+    case OP_SNE_VX_BYTE:
+      C8_SELECT(this->pc[lane], this->pc[lane] + (Vx[lane] != op.kk ? 4 : 2));
+      return;
+
+    case OP_LD_VX_BYTE:
+      C8_SELECT(Vx[lane], op.kk);
+      break;
+
+    case OP_ADD_VX_BYTE:
+      C8_SELECT(Vx[lane], Vx[lane] + op.kk);
+      break;
+
+    case OP_LD_VX_VY:
+      C8_SELECT(Vx[lane], Vy[lane]);
+      break;
+
+    case OP_OR_VX_VY:
+      C8_SELECT(Vx[lane], Vx[lane] | Vy[lane]);
+      break;
+
+    case OP_AND_VX_VY:
+      C8_SELECT(Vx[lane], Vx[lane] & Vy[lane]);
+      break;
+
+    case OP_XOR_VX_VY:
+      C8_SELECT(Vx[lane], Vx[lane] ^ Vy[lane]);
+      break;
+
+    case OP_ADD_VX_VY:
+      C8_SELECT(Vx[lane], Vx[lane] + Vy[lane]);
+      C8_SELECT(VF[lane], 0);
+      C8_SELECT(VF[lane], Vy[lane] > 0xFF - Vx[lane] ? 1 : VF[lane]);
+      break;
+
+    case OP_SUB_VX_VY:
+      C8_SELECT(VF[lane], 1);
+      C8_SELECT(VF[lane], Vy[lane] > Vx[lane] ? 0 : VF[lane]);
+      C8_SELECT(Vx[lane], Vx[lane] - Vy[lane]);
+      break;
+
+    case OP_SHR_VX:
+      C8_SELECT(VF[lane], Vx[lane] & 0x1);
+      C8_SELECT(Vx[lane], Vx[lane] >> 1);
+      break;
+
+    case OP_SUBN_VX_VY:
+      C8_SELECT(VF[lane], 1);
+      C8_SELECT(VF[lane], Vx[lane] > Vy[lane] ? 0 : VF[lane]);
+      C8_SELECT(Vx[lane], Vy[lane] - Vx[lane]);
+      break;
+
+    case OP_SHL_VX:
+      C8_SELECT(VF[lane], Vx[lane] >> 7);
+      C8_SELECT(Vx[lane], Vx[lane] << 1);
+      break;
+
+    case OP_LD_I_ADDR:
+      C8_SELECT(this->I[lane], op.nnn);
+      break;
+
+    case OP_RND_VX_BYTE:
+      C8_EACH_ACTIVE
+      {
+        Vx[lane] = (nextRandom(this->random[lane]) % (0xFF + 1)) & op.kk;
+      }
+      break;
+
+    case OP_DRW_VX_VY_NIBBLE:
+      C8_EACH_ACTIVE
+      {
+        this->draw(lane, op.x, op.y, op.n);
+      }
+      break;
+
+    case OP_SKP_VX:
+      C8_SELECT(this->pc[lane], this->pc[lane] + (this->key[lane][Vx[lane] & 0xF] != 0 ? 4 : 2));
+      return;
+
+    case OP_SKNP_VX:
+      C8_SELECT(this->pc[lane], this->pc[lane] + (this->key[lane][Vx[lane] & 0xF] == 0 ? 4 : 2));
+      return;
+
+    case OP_LD_VX_DT:
+      C8_SELECT(Vx[lane], this->timer(this->delayExpires[lane], lane));
+      break;
+
+    case OP_LD_DT_VX:
+      C8_SELECT(this->delayExpires[lane], this->frame(lane) + Vx[lane]);
+      break;
+
+    case OP_LD_ST_VX:
+      C8_EACH_ACTIVE
+      {
+        // a sound timer running out before this one replaces it still beeps
+        this->settleSound(lane);
+        this->soundExpires[lane] = Vx[lane] != 0 ? this->frame(lane) + Vx[lane] : 0;
+      }
+      break;
+
+    case OP_ADD_I_VX:
+    {
+      // from Vx as it was before VF changes, x may be F
+      uint32_t sum[N];
+      C8_LANES { sum[lane] = this->I[lane] + Vx[lane]; }
+      C8_SELECT(VF[lane], sum[lane] > 0xFFF ? 1 : 0);
+      C8_SELECT(this->I[lane], sum[lane]);
+      break;
+    }
+
+    case OP_LD_F_VX:
+      C8_SELECT(this->I[lane], Vx[lane] * 0x5);
+      break;
+
+    case OP_LD_B_VX:
+      C8_EACH_ACTIVE
+      {
+        uint8_t *memory = this->memory[lane];
+        uint16_t address = this->I[lane];
+        memory[address & 0xFFF]       = Vx[lane] / 100;
+        memory[(address + 1) & 0xFFF] = (Vx[lane] / 10) % 10;
+        memory[(address + 2) & 0xFFF] = (Vx[lane] % 100) % 10;
+      }
+      break;
+
+    case OP_LD_VX_I:
+      for (int i = 0; i <= op.x; ++i)
+      {
+        C8_SELECT(this->V[i][lane], this->memory[lane][(this->I[lane] + i) & 0xFFF]);
+      }
+      C8_SELECT(this->I[lane], this->I[lane] + op.x + 1);
+      break;
+
+    case OP_LD_VX_K:
+      // the program counter stays put until awaitKey() has a key
+      C8_SELECT(this->keyWait[lane], C8_KEY_WAIT | op.x);
+      C8_SELECT(this->keyHeld[lane], C8_NO_KEY);
+      return;
+
+    default:
+      C8_EACH_ACTIVE
+      {
+        this->halted[lane] = true;
+      }
+      return;
+  }
+
+  C8_SELECT(this->pc[lane], this->pc[lane] + 2);
+}
+
+/*
+  Chip8::draw() for one lane
+*/
+template<int N>
+void
+Processor::Lanes<N>::draw(int lane, uint8_t x, uint8_t y, uint8_t height)
+{
+  unsigned short xCoord = this->V[x][lane];
+  unsigned short yCoord = this->V[y][lane];
+
+  this->V[0xF][lane] = 0;
+
+  for ( int yline = 0; yline < height; yline++ )
+  {
+    uint64_t sprite = spriteRow(this->memory[lane][(this->I[lane] + yline) & 0xFFF], xCoord);
+    uint64_t &row = this->graphicsBuffer[lane][(yCoord + yline) % C8_GFX_WIDTH];
+    if ( (row & sprite) != 0 )
+    {
+      this->V[0xF][lane] = 1;
+    }
+    row ^= sprite;
+  }
+  this->drawFlag[lane] = true;
+}
+
+/*
+  Compares one lane with a processor, the same state Chip8::operator== does
+*/
+template<int N>
+bool
+Processor::Lanes<N>::matches(int lane, const Chip8 &c8) const
+{
+  for (int i = 0; i < 16; ++i)
+  {
+    if ( this->V[i][lane] != c8.registers[i] || this->stack[i][lane] != c8.stack[i] )
+    {
+      return false;
+    }
+  }
+  return this->sp[lane] == c8.sp
+    && this->I[lane] == c8.indexRegister
+    && this->pc[lane] == c8.programCounter
+    && this->keyWait[lane] == c8.keyWait
+    && this->timer(this->delayExpires[lane], lane) == c8.delayTimer()
+    && this->timer(this->soundExpires[lane], lane) == c8.soundTimer()
+    && memcmp(this->memory[lane], c8.memory, sizeof(c8.memory)) == 0
+    && memcmp(this->graphicsBuffer[lane], c8.graphicsBuffer, sizeof(c8.graphicsBuffer)) == 0;
+}
+
+template class Processor::Lanes<8>;
+template class Processor::Lanes<16>;
+template class Processor::Lanes<32>;
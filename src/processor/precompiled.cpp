@@ -0,0 +1,82 @@
+#include "processor/precompiled.hpp"
+
+// function local so generated translation units can register during static initialization
+std::vector<const Processor::PrecompiledRom *> &
+Processor::Precompiled::registry()
+{
+  static std::vector<const PrecompiledRom *> roms;
+  return roms;
+}
+
+void
+Processor::Precompiled::add(const PrecompiledRom *rom)
+{
+  Precompiled::registry().push_back(rom);
+}
+
+/*
+  The registered ROM whose image is loaded at 0x200, if any
+*/
+const Processor::PrecompiledRom *
+Processor::Precompiled::find(const uint8_t *memory)
+{
+  std::vector<const PrecompiledRom *> &roms = Precompiled::registry();
+  for (size_t i = 0; i < roms.size(); ++i)
+  {
+    if ( memcmp(memory + C8_MEMORY_OFFSET, roms[i]->image, roms[i]->size) == 0 )
+    {
+      return roms[i];
+    }
+  }
+  return NULL;
+}
+
+Processor::Precompiled::Precompiled(const PrecompiledRom *rom)
+{
+  this->rom = rom;
+  for (int i = 0; i < 4096; ++i)
+  {
+    this->blockAt[i] = NULL;
+  }
+  for (uint16_t i = 0; i < rom->count; ++i)
+  {
+    this->blockAt[rom->blocks[i].start] = &rom->blocks[i];
+  }
+}
+
+const Processor::PrecompiledBlock *
+Processor::Precompiled::lookup(uint16_t address) const
+{
+  return address < 4096 ? this->blockAt[address] : NULL;
+}
+
+/*
+  Blocks built from bytes that have since been overwritten are dropped for
+  good, the interpreter runs that code from then on.
+*/
+void
+Processor::Precompiled::invalidate(uint16_t address, uint16_t length)
+{
+  uint32_t end = address + length;
+  for (uint16_t i = 0; i < this->rom->count; ++i)
+  {
+    const PrecompiledBlock &block = this->rom->blocks[i];
+    if ( block.end > address && block.start < end )
+    {
+      this->blockAt[block.start] = NULL;
+    }
+  }
+}
+
+/*
+  Runs one instruction through its interpreter handler, at the current
+  program counter, exactly like cycle() would after fetching it.
+*/
+void
+Processor::Precompiled::execute(Chip8 &c8, uint16_t opCode)
+{
+  c8.opCode = opCode;
+  c8.instruction = &Chip8::decodeTable[opCode];
+  (c8.*(c8.instruction->handler))();
+  ++c8.clock;
+}
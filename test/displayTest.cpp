@@ -0,0 +1,94 @@
+#include "test/catch.hpp"
+#include "display/backend.hpp"
+#include "display/frame_pacer.hpp"
+#include "display/triple_buffer.hpp"
+#include <chrono>
+#include <thread>
+
+TEST_CASE("The framebuffer backend keeps the last refreshed frame", "[display]")
+{
+  Display::Backend *backend = Display::createBackend("framebuffer");
+  Display::FramebufferBackend *framebuffer = dynamic_cast<Display::FramebufferBackend *>(backend);
+  REQUIRE( framebuffer != NULL );
+
+  backend->pushToBuffer(65, 0xFFFFFFFF);
+  REQUIRE( framebuffer->frame[65] == 0 );
+  backend->refresh();
+  REQUIRE( framebuffer->frame[65] == 0xFFFFFFFF );
+  REQUIRE( framebuffer->frames == 1 );
+
+  // nothing pushed, nothing to show
+  backend->refresh();
+  REQUIRE( framebuffer->frames == 1 );
+
+  std::string text;
+  framebuffer->print(text);
+  REQUIRE( text.substr(65, 2) == ".#" );
+
+  REQUIRE( Display::createBackend("teletype") == NULL );
+  delete backend;
+}
+
+TEST_CASE("The triple buffer hands over the latest frame without tearing", "[display]")
+{
+  Display::TripleBuffer<Display::Frame> frames;
+  REQUIRE_FALSE( frames.update() );
+
+  frames.back().rows[0] = 1;
+  frames.publish();
+  frames.back().rows[0] = 2;
+  frames.publish();
+  REQUIRE( frames.update() );
+  REQUIRE( frames.front().rows[0] == 2 );
+  REQUIRE_FALSE( frames.update() );
+
+  // every row of a published frame holds the same value, a torn frame would not
+  std::thread writer([&frames]() {
+    for (uint64_t value = 3; value < 100000; ++value)
+    {
+      for (int row = 0; row < C8_GFX_WIDTH; ++row)
+      {
+        frames.back().rows[row] = value;
+      }
+      frames.publish();
+    }
+  });
+
+  uint64_t last = 2;
+  bool consistent = true;
+  while (last < 99999)
+  {
+    if (frames.update())
+    {
+      const Display::Frame &frame = frames.front();
+      for (int row = 0; row < C8_GFX_WIDTH; ++row)
+      {
+        consistent = consistent && frame.rows[row] == frame.rows[0];
+      }
+      consistent = consistent && frame.rows[0] > last;
+      last = frame.rows[0];
+    }
+  }
+  writer.join();
+  REQUIRE( consistent );
+}
+
+TEST_CASE("The frame pacer starts frames on period boundaries", "[display]")
+{
+  Display::FramePacer pacer(200, 500);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < 10; ++frame)
+  {
+    pacer.wait();
+  }
+  std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+  Display::PacingStats stats = pacer.stats();
+  REQUIRE( stats.frames + stats.missed == 10 );
+  REQUIRE( elapsed >= std::chrono::milliseconds(45) );
+  REQUIRE( stats.worst >= 0 );
+
+  std::string report;
+  pacer.report(report);
+  REQUIRE( report.find("jitter") != std::string::npos );
+}
@@ -0,0 +1,68 @@
+#include "test/catch.hpp"
+#include "host/emulator.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+// polls `done` for up to two seconds
+template<typename Condition>
+static bool
+within(Condition done)
+{
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (!done() && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return done();
+}
+
+TEST_CASE("Keys from the queue wake a processor blocked on Fx0A", "[host]")
+{
+  const uint8_t program[] = {
+    0xF3, 0x0A,   // V3 = K
+    0xFF, 0xFF    // and halt
+  };
+  const char *path = "/tmp/c8_host_key.ch8";
+  std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(program), sizeof(program));
+
+  Processor::Chip8 c8(path);
+  c8.initialize();
+  Input::Keypad keypad;
+  Display::NullBackend window;
+  Display::FramePacer pacer(C8_TIMER_HZ, 500);
+  Host::Signals signals;
+  signals.running = true;
+  signals.paused = false;
+  signals.blocked = false;
+  signals.events = 0;
+
+  // paced and unbounded, the way the window runs it
+  std::streambuf *err = std::cerr.rdbuf(NULL);
+  std::thread processor(Host::emulate, &c8, 0UL, &window, &keypad,
+    (Display::TripleBuffer<Display::Frame> *)NULL, &signals, &pacer);
+
+  bool blocked = within([&signals]() { return signals.blocked.load(); });
+
+  // what the window thread does with a key tap
+  keypad.press('w', true, Input::clock());
+  keypad.press('w', false, Input::clock());
+  Host::notifyInput(&signals);
+
+  bool finished = within([&signals]() { return !signals.running.load(); });
+  if (!finished)
+  {
+    signals.running = false;
+    Host::notifyInput(&signals);
+  }
+  processor.join();
+  std::cerr.rdbuf(err);
+  std::cerr.clear();
+
+  REQUIRE( blocked );
+  REQUIRE( finished );
+  REQUIRE( c8.halted );
+  REQUIRE( c8.getRegisters()[0x3] == 0x5 );
+  REQUIRE( c8.getProgramCounter() == 0x202 );
+}
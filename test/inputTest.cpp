@@ -0,0 +1,70 @@
+#include "test/catch.hpp"
+#include "input/keypad.hpp"
+#include <thread>
+
+TEST_CASE("The keypad maps host keys through a configurable layout", "[input]")
+{
+  Input::Keypad keypad;
+  REQUIRE( keypad.key('x') == 0x0 );
+  REQUIRE( keypad.key('1') == 0x1 );
+  REQUIRE( keypad.key('v') == 0xF );
+  REQUIRE( keypad.key('p') == -1 );
+
+  REQUIRE_FALSE( keypad.setLayout("0123456789abcde") );
+  REQUIRE_FALSE( keypad.setLayout("0123456789abcdee") );
+  REQUIRE( keypad.key('x') == 0x0 );
+
+  REQUIRE( keypad.setLayout("0123456789ABCDEF") );
+  REQUIRE( keypad.key('a') == 0xA );
+  REQUIRE( keypad.key('x') == -1 );
+}
+
+TEST_CASE("Key events come off the queue in order with their timestamps", "[input]")
+{
+  Input::Keypad keypad;
+  Input::KeyEvent event;
+  REQUIRE_FALSE( keypad.next(event) );
+
+  REQUIRE( keypad.press('w', true, 100) );
+  REQUIRE_FALSE( keypad.press('p', true, 150) );
+  REQUIRE( keypad.press('w', false, 200) );
+
+  REQUIRE( keypad.next(event) );
+  REQUIRE( event.key == 0x5 );
+  REQUIRE( event.down );
+  REQUIRE( event.time == 100 );
+  REQUIRE( keypad.next(event) );
+  REQUIRE_FALSE( event.down );
+  REQUIRE( event.time == 200 );
+  REQUIRE_FALSE( keypad.next(event) );
+
+  // a full queue drops new events
+  bool queued = true;
+  for (int i = 0; i < C8_KEY_QUEUE_SIZE; ++i)
+  {
+    queued = queued && keypad.press('q', i % 2 == 0, i);
+  }
+  REQUIRE( queued );
+  REQUIRE_FALSE( keypad.press('q', true, C8_KEY_QUEUE_SIZE) );
+
+  // and one thread can press while another takes them off
+  while (keypad.next(event)) {}
+  std::thread window([&keypad]() {
+    for (int64_t i = 0; i < 100000; )
+    {
+      i += keypad.press('z', true, i) ? 1 : 0;
+    }
+  });
+  int64_t expected = 0;
+  bool ordered = true;
+  while (expected < 100000)
+  {
+    if (keypad.next(event))
+    {
+      ordered = ordered && event.time == expected && event.key == 0xA;
+      ++expected;
+    }
+  }
+  window.join();
+  REQUIRE( ordered );
+}
@@ -0,0 +1,694 @@
+#include "test/catch.hpp"
+#include "processor/chip8.hpp"
+#include "processor/lanes.hpp"
+#include <sstream>
+
+TEST_CASE("Opcodes are decoded into their operand fields", "[processor]")
+{
+  Processor::Chip8::Instruction drw = Processor::Chip8::decode(0xD235);
+  REQUIRE( drw.nnn == 0x235 );
+  REQUIRE( drw.x   == 0x2 );
+  REQUIRE( drw.y   == 0x3 );
+  REQUIRE( drw.n   == 0x5 );
+  REQUIRE( drw.kk  == 0x35 );
+
+  Processor::Chip8::Instruction ld = Processor::Chip8::decode(0x6AFF);
+  REQUIRE( ld.x  == 0xA );
+  REQUIRE( ld.kk == 0xFF );
+}
+
+TEST_CASE("Handlers are specialized per register but not per immediate", "[processor]")
+{
+  REQUIRE( Processor::Chip8::decode(0x6A00).handler == Processor::Chip8::decode(0x6AFF).handler );
+  REQUIRE( Processor::Chip8::decode(0x6A00).handler != Processor::Chip8::decode(0x6B00).handler );
+  REQUIRE( Processor::Chip8::decode(0x8124).handler != Processor::Chip8::decode(0x8134).handler );
+  REQUIRE( Processor::Chip8::decode(0x8124).handler != Processor::Chip8::decode(0x8125).handler );
+  REQUIRE( Processor::Chip8::decode(0xF007).handler != Processor::Chip8::decode(0xF015).handler );
+}
+
+static void
+runFor(Processor::Chip8 &c8, uint32_t cycles)
+{
+  // engine fallbacks and traces log to stdout, keep the test output readable
+  std::streambuf *out = std::cout.rdbuf(NULL);
+
+  uint32_t executed = 0;
+  while (executed < cycles && !c8.halted)
+  {
+    executed += c8.run(cycles - executed);
+    c8.drawFlag = false;
+  }
+
+  std::cout.rdbuf(out);
+  std::cout.clear();
+}
+
+static const char *
+writeRom(const char *path, const uint8_t *bytes, size_t length)
+{
+  std::ofstream rom(path, std::ios::binary);
+  rom.write(reinterpret_cast<const char *>(bytes), length);
+  return path;
+}
+
+#if C8_TRACE_LEVEL > C8_TRACE_OFF
+TEST_CASE("Instructions are only traced while tracing is enabled", "[processor]")
+{
+  const uint8_t bytes[] = { 0x6A, 0x02, 0x6B, 0x03 };
+  Processor::Chip8 c8(writeRom("/tmp/c8_trace.ch8", bytes, sizeof(bytes)));
+  c8.initialize();
+
+  std::ostringstream traced;
+  std::streambuf *out = std::cout.rdbuf(traced.rdbuf());
+  c8.run(1);
+  Debug::traceEnabled() = true;
+  c8.run(1);
+  Debug::traceEnabled() = false;
+  std::cout.rdbuf(out);
+
+  REQUIRE( traced.str().find("ld_vx_byte") != std::string::npos );
+  REQUIRE( traced.str().find("6A02") == std::string::npos );
+  REQUIRE( traced.str().find("6B03") != std::string::npos );
+}
+#endif
+
+TEST_CASE("Binary traces record every instruction and the register it changed", "[processor]")
+{
+  const uint8_t bytes[] = { 0x6A, 0x02, 0xA3, 0x00, 0x7A, 0x01, 0x12, 0x04 };
+  Processor::Chip8 c8(writeRom("/tmp/c8_ring.ch8", bytes, sizeof(bytes)));
+  c8.initialize();
+  c8.setEngine(Processor::ENGINE_THREADED);
+  REQUIRE( c8.recordTrace("/tmp/c8_ring.trace") );
+  runFor(c8, 100000);
+  REQUIRE( c8.recordTrace("/dev/null") );    // closes the first trace
+
+  std::ifstream trace("/tmp/c8_ring.trace", std::ios::binary);
+  Debug::TraceHeader header;
+  trace.read(reinterpret_cast<char *>(&header), sizeof(header));
+  REQUIRE( memcmp(header.magic, C8_TRACE_MAGIC, 4) == 0 );
+
+  std::vector<Debug::TraceRecord> records(100001);
+  trace.read(reinterpret_cast<char *>(&records[0]), records.size() * sizeof(Debug::TraceRecord));
+  REQUIRE( trace.gcount() == 100000 * sizeof(Debug::TraceRecord) );
+
+  REQUIRE( records[0].pc == 0x200 );
+  REQUIRE( records[0].reg == 0xA );
+  REQUIRE( records[0].value == 0x02 );
+  REQUIRE( records[1].I == 0x300 );
+  REQUIRE( records[1].reg == C8_TRACE_NO_REGISTER );
+  REQUIRE( records[99999].cycle == 99999 );
+  REQUIRE( records[99999].opCode == 0x1204 );
+}
+
+TEST_CASE("Binary traces started mid-run record the emulated clock", "[processor]")
+{
+  const uint8_t bytes[] = { 0x6A, 0x02, 0xA3, 0x00, 0x7A, 0x01, 0x12, 0x04 };
+  Processor::Chip8 c8(writeRom("/tmp/c8_ring_late.ch8", bytes, sizeof(bytes)));
+  c8.initialize();
+  runFor(c8, 1000);
+  REQUIRE( c8.recordTrace("/tmp/c8_ring_late.trace") );
+  runFor(c8, 500);
+  REQUIRE( c8.recordTrace("/dev/null") );
+
+  std::ifstream trace("/tmp/c8_ring_late.trace", std::ios::binary);
+  Debug::TraceHeader header;
+  trace.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+  std::vector<Debug::TraceRecord> records(501);
+  trace.read(reinterpret_cast<char *>(&records[0]), records.size() * sizeof(Debug::TraceRecord));
+  REQUIRE( trace.gcount() == 500 * sizeof(Debug::TraceRecord) );
+
+  REQUIRE( records[0].cycle == 1000 );
+  REQUIRE( records[499].cycle == 1499 );
+  REQUIRE( records[0].opCode == 0x7A01 );
+}
+
+TEST_CASE("Profiles rank addresses by the time spent at them", "[processor]")
+{
+  Debug::Profile *profile = new Debug::Profile();
+  profile->clear();
+  for (int i = 0; i < 3; ++i)
+  {
+    profile->instruction(0x200, 0x6A02, Processor::OP_LD_VX_BYTE);
+  }
+  profile->instruction(0x202, 0xDAB6, Processor::OP_DRW_VX_VY_NIBBLE);
+  profile->instruction(0x204, 0x1204, Processor::OP_JP_ADDR);
+  profile->skipped(0x204, 10);
+
+  std::ostringstream report;
+  profile->report(report, 2);
+  REQUIRE( report.str().find("5 instructions executed, 10 skipped") == 0 );
+  REQUIRE( report.str().find("0x204") < report.str().find("0x200") );
+  REQUIRE( report.str().find("0x202") == std::string::npos );
+  REQUIRE( report.str().find("ld_vx_byte") != std::string::npos );
+  REQUIRE( report.str().find("Dxyn") != std::string::npos );
+
+  REQUIRE( profile->write("/tmp/c8_profile.json") );
+  std::ifstream file("/tmp/c8_profile.json");
+  std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  REQUIRE( json.find("{\"pc\":516,\"opcode\":4612,\"executed\":1,\"idle\":10}") != std::string::npos );
+  REQUIRE( json.find("\"ld_vx_byte\":3") != std::string::npos );
+  delete profile;
+}
+
+TEST_CASE("The call graph charges time to the subroutine running", "[processor]")
+{
+  Debug::CallGraph graph;
+  graph.instruction();
+  graph.instruction();
+  graph.call(0x300);
+  for (int i = 0; i < 3; ++i)
+  {
+    graph.instruction();
+  }
+  graph.call(0x400);
+  graph.instruction();
+  graph.skipped(5);
+  graph.ret();
+  graph.instruction();
+  graph.ret();
+  graph.instruction();
+
+  // nested deeper than is tracked, and back out again
+  for (int i = 0; i < C8_PROFILE_MAX_DEPTH + 4; ++i)
+  {
+    graph.call(0x500);
+  }
+  for (int i = 0; i < C8_PROFILE_MAX_DEPTH + 4; ++i)
+  {
+    graph.ret();
+  }
+  graph.instruction();
+
+  std::ostringstream folded;
+  graph.folded(folded);
+  REQUIRE( folded.str() == "main 4\nmain;sub_300 4\nmain;sub_300;sub_400 6\n" );
+
+  std::ostringstream report;
+  graph.report(report, 3);
+  REQUIRE( report.str().find("sub_300             1             5             4") != std::string::npos );
+  REQUIRE( report.str().find("sub_500") == std::string::npos );
+}
+
+TEST_CASE("A saved state resumes exactly where it was taken", "[processor]")
+{
+  Processor::Chip8 original("resources/pong");
+  original.initialize();
+  original.seed(1);
+  original.setEngine(Processor::ENGINE_BLOCK);
+  runFor(original, 10000);
+
+  Processor::Chip8State *snapshot = new Processor::Chip8State;
+  original.save(*snapshot);
+  runFor(original, 10000);
+
+  Processor::Chip8 restored("resources/pong");
+  restored.initialize();
+  restored.setEngine(Processor::ENGINE_BLOCK);
+  runFor(restored, 123);
+  restored.load(*snapshot);
+  runFor(restored, 10000);
+
+  REQUIRE( restored == original );
+  delete snapshot;
+}
+
+TEST_CASE("Unimplemented opcodes halt the processor instead of exiting", "[processor]")
+{
+  const uint8_t bytes[] = { 0x6A, 0x02, 0x7A, 0x01, 0xFF, 0xFF, 0x6A, 0x09 };
+  const char *rom = writeRom("/tmp/c8_halt.ch8", bytes, sizeof(bytes));
+  Processor::Engine engines[] = {
+    Processor::ENGINE_DISPATCH, Processor::ENGINE_THREADED, Processor::ENGINE_BLOCK, Processor::ENGINE_JIT
+  };
+
+  for (int i = 0; i < 4; ++i)
+  {
+    Processor::Chip8 c8(rom);
+    c8.initialize();
+    c8.setEngine(engines[i]);
+
+    std::streambuf *err = std::cerr.rdbuf(NULL);
+    uint32_t executed = c8.run(100);
+    std::cerr.rdbuf(err);
+    std::cerr.clear();
+
+    REQUIRE( c8.halted );
+    REQUIRE( executed == 2 );
+    REQUIRE( c8.getProgramCounter() == 0x204 );
+    REQUIRE( c8.getRegisters()[0xA] == 0x03 );
+    REQUIRE( c8.run(100) == 0 );
+  }
+}
+
+TEST_CASE("The threaded engine matches the dispatch engine", "[processor]")
+{
+  Processor::Chip8 dispatch("resources/pong");
+  Processor::Chip8 threaded("resources/pong");
+  dispatch.initialize();
+  threaded.initialize();
+  threaded.setEngine(Processor::ENGINE_THREADED);
+
+  dispatch.seed(1);
+  runFor(dispatch, 50000);
+  threaded.seed(1);
+  runFor(threaded, 50000);
+
+  REQUIRE( dispatch == threaded );
+}
+
+TEST_CASE("The block engine matches the dispatch engine", "[processor]")
+{
+  Processor::Chip8 dispatch("resources/pong");
+  Processor::Chip8 blocks("resources/pong");
+  dispatch.initialize();
+  blocks.initialize();
+  blocks.setEngine(Processor::ENGINE_BLOCK);
+
+  dispatch.seed(1);
+  runFor(dispatch, 50000);
+  blocks.seed(1);
+  runFor(blocks, 50000);
+
+  REQUIRE( dispatch == blocks );
+}
+
+TEST_CASE("The block engine drops blocks overwritten by the running code", "[processor]")
+{
+  const uint8_t program[] = {
+    0x60, 0xC8,   // LD V0, 200
+    0xA2, 0x08,   // LD I, 0x208
+    0xF0, 0x33,   // LD B, V0      -> rewrites 0x208 - 0x20A with 02 00 00
+    0x61, 0x05,   // LD V1, 5
+    0x62, 0x07,   // LD V2, 7      -> becomes CLS
+    0x12, 0x00,   // JP 0x200      -> becomes CLS
+    0x12, 0x0C    // JP 0x20C
+  };
+  const char *path = writeRom("/tmp/c8_selfmodify.ch8", program, sizeof(program));
+
+  Processor::Chip8 dispatch(path);
+  Processor::Chip8 blocks(path);
+  dispatch.initialize();
+  blocks.initialize();
+  blocks.setEngine(Processor::ENGINE_BLOCK);
+
+  runFor(dispatch, 12);
+  runFor(blocks, 12);
+
+  REQUIRE( dispatch == blocks );
+}
+
+TEST_CASE("The instruction at the last address of memory wraps around to 0x000", "[processor]")
+{
+  // a ROM filling memory up to 0xFFF, where only the first byte of an instruction fits
+  std::vector<uint8_t> program(4096 - 0x200, 0);
+  program[0] = 0x1F; program[1] = 0xFF;   // jp 0xFFF
+  program[0xFF0 - 0x200] = 0x12;          // jp 0x200
+  program.back() = 0x1F;                  // with the font's first byte (F0) at 0x000, jp 0xFF0
+  const char *path = writeRom("/tmp/c8_last.ch8", &program[0], program.size());
+
+  Processor::Chip8 dispatch(path);
+  dispatch.initialize();
+  runFor(dispatch, 2);
+  REQUIRE( dispatch.getProgramCounter() == 0xFF0 );
+  runFor(dispatch, 998);
+  REQUIRE( dispatch.getClock() == 1000 );
+  REQUIRE( dispatch.getProgramCounter() == 0xFFF );
+
+  const Processor::Engine engines[] = { Processor::ENGINE_THREADED, Processor::ENGINE_BLOCK, Processor::ENGINE_JIT };
+  for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e)
+  {
+    Processor::Chip8 other(path);
+    other.initialize();
+    other.setEngine(engines[e]);
+    runFor(other, 1000);
+    REQUIRE( other.getClock() == 1000 );
+    REQUIRE( dispatch == other );
+  }
+}
+
+TEST_CASE("I, the stack pointer and key numbers wrap instead of leaving their arrays", "[processor]")
+{
+  const uint8_t program[] = {
+    0x60, 0xFF,   // V0 = 255
+    0xAF, 0xFE,   // I = 0xFFE
+    0xF0, 0x33,   // 2, 5, 5 at 0xFFE, 0xFFF and 0x000
+    0xF2, 0x65,   // read them back, I = 0x1001
+    0xF0, 0x33,   // 0, 0, 2 at 0x001
+    0x63, 0x13,   // V3 = 0x13
+    0xE3, 0x9E,   // skip if key 3 is down
+    0xFF, 0xFF,   // halt
+    0x22, 0x10    // call itself, deeper than the stack
+  };
+  const char *path = writeRom("/tmp/c8_wrap.ch8", program, sizeof(program));
+
+  const Processor::Engine engines[] = {
+    Processor::ENGINE_DISPATCH, Processor::ENGINE_THREADED, Processor::ENGINE_BLOCK, Processor::ENGINE_JIT
+  };
+  for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e)
+  {
+    Processor::Chip8 c8(path);
+    c8.initialize();
+    c8.setEngine(engines[e]);
+    c8.key[0x3] = 1;
+    runFor(c8, 27);
+
+    Processor::Chip8State *state = new Processor::Chip8State;
+    c8.save(*state);
+    REQUIRE( !c8.halted );
+    REQUIRE( c8.getRegisters()[0x0] == 2 );
+    REQUIRE( c8.getRegisters()[0x1] == 5 );
+    REQUIRE( c8.getRegisters()[0x2] == 5 );
+    REQUIRE( c8.getIndexRegister() == 0x1001 );
+    REQUIRE( c8.memory[0xFFE] == 2 );
+    REQUIRE( c8.memory[0xFFF] == 5 );
+    REQUIRE( c8.memory[0x000] == 5 );
+    REQUIRE( c8.memory[0x003] == 2 );
+    REQUIRE( c8.getProgramCounter() == 0x210 );
+    REQUIRE( state->sp == 20 );
+    REQUIRE( state->stack[0x3] == 0x210 );
+    delete state;
+  }
+}
+
+TEST_CASE("The JIT engine matches the dispatch engine", "[processor]")
+{
+  Processor::Chip8 dispatch("resources/pong");
+  Processor::Chip8 jit("resources/pong");
+  dispatch.initialize();
+  jit.initialize();
+  jit.setEngine(Processor::ENGINE_JIT);
+
+  dispatch.seed(1);
+  runFor(dispatch, 50000);
+  jit.seed(1);
+  runFor(jit, 50000);
+
+  REQUIRE( dispatch == jit );
+}
+
+TEST_CASE("The precompiled engine matches the dispatch engine", "[processor]")
+{
+  Processor::Chip8 dispatch("resources/pong");
+  Processor::Chip8 precompiled("resources/pong");
+  dispatch.initialize();
+  precompiled.initialize();
+  precompiled.setEngine(Processor::ENGINE_PRECOMPILED);
+
+  // the test suite links in c8rc's translation of pong
+  REQUIRE( precompiled.getEngine() == Processor::ENGINE_PRECOMPILED );
+
+  dispatch.seed(1);
+  runFor(dispatch, 50000);
+  precompiled.seed(1);
+  runFor(precompiled, 50000);
+
+  REQUIRE( dispatch == precompiled );
+}
+
+TEST_CASE("The JIT engine matches the dispatch engine on every ALU operation", "[processor]")
+{
+  // a pseudo random mix of everything the JIT compiles, VF included as an operand
+  const uint16_t forms[] = { 0x6000, 0x7000, 0x8000, 0x8001, 0x8002, 0x8003, 0x8004, 0x8005,
+                             0x8006, 0x8007, 0x800E, 0xA000, 0xF01E, 0xF029, 0x3000, 0x4000 };
+  uint8_t program[512] = {
+    0xAF, 0xF0,   // I = 0xFF0
+    0x6F, 0x20,   // VF = 0x20
+    0xFF, 0x1E    // I += VF, which overflows, before VF becomes the flag
+  };
+  uint32_t seed = 12345;
+  size_t length = 6;
+
+  while (length < sizeof(program) - 4)
+  {
+    seed = seed * 1103515245 + 12345;
+    uint16_t form = forms[(seed >> 16) % 16];
+    uint16_t operands = (seed >> 4) & 0x0FFF;
+    uint16_t opCode = form;
+
+    if ( (form & 0xF000) == 0x8000 )
+    {
+      opCode |= operands & 0x0FF0;
+    }
+    else if ( (form & 0xF000) == 0xF000 )
+    {
+      opCode |= operands & 0x0F00;
+    }
+    else
+    {
+      opCode |= operands;
+    }
+
+    program[length++] = opCode >> 8;
+    program[length++] = opCode & 0xFF;
+  }
+  // loop forever, twice so a skip can't fall off the end
+  program[length++] = 0x12; program[length++] = 0x00;
+  program[length++] = 0x12; program[length++] = 0x00;
+
+  const char *path = writeRom("/tmp/c8_alu.ch8", program, length);
+
+  Processor::Chip8 dispatch(path);
+  Processor::Chip8 jit(path);
+  dispatch.initialize();
+  jit.initialize();
+  jit.setEngine(Processor::ENGINE_JIT);
+
+  // compare often, so results that are overwritten later still get checked
+  bool same = true;
+  for (uint32_t step = 0; step < 10000 && same; ++step)
+  {
+    runFor(dispatch, step % 13 + 1);
+    runFor(jit, step % 13 + 1);
+    same = dispatch == jit;
+  }
+
+  REQUIRE( same );
+}
+
+TEST_CASE("Sprites wrap around both edges and report collisions", "[processor]")
+{
+  const uint8_t program[] = {
+    0x60, 0x3C,   // V0 = 60
+    0x61, 0x1F,   // V1 = 31
+    0xA2, 0x0C,   // I = sprite
+    0xD0, 0x12,   // draw 8x2 at (60, 31)
+    0xD0, 0x12,   // and again, erasing it
+    0x12, 0x0A,   // loop
+    0xFF, 0x81    // sprite
+  };
+  Processor::Chip8 c8(writeRom("/tmp/c8_draw.ch8", program, sizeof(program)));
+  c8.initialize();
+
+  runFor(c8, 4);
+  REQUIRE( c8.pixel(60, 31) );
+  REQUIRE( c8.pixel(63, 31) );
+  REQUIRE( c8.pixel(0, 31) );
+  REQUIRE( c8.pixel(3, 31) );
+  REQUIRE_FALSE( c8.pixel(4, 31) );
+  REQUIRE_FALSE( c8.pixel(59, 31) );
+  REQUIRE( c8.pixel(60, 0) );
+  REQUIRE_FALSE( c8.pixel(61, 0) );
+  REQUIRE( c8.pixel(3, 0) );
+  REQUIRE( c8.getRegisters()[0xF] == 0 );
+  REQUIRE( c8.dirtyRows == ((1U << 31) | 1U) );
+
+  c8.dirtyRows = 0;
+  runFor(c8, 1);
+  REQUIRE( c8.dirtyRows == ((1U << 31) | 1U) );
+  REQUIRE( c8.getRegisters()[0xF] == 1 );
+  for (int y = 0; y < C8_GFX_WIDTH; ++y)
+  {
+    REQUIRE( c8.graphicsBuffer[y] == 0 );
+  }
+}
+
+TEST_CASE("Timers count down once per frame of instructions", "[processor]")
+{
+  const uint8_t program[] = {
+    0x6A, 0x05,   // VA = 5
+    0xFA, 0x15,   // DT = VA
+    0xFA, 0x18,   // ST = VA
+    0xFB, 0x07,   // VB = DT
+    0x12, 0x06    // loop
+  };
+  const char *path = writeRom("/tmp/c8_timers.ch8", program, sizeof(program));
+
+  Processor::Chip8 c8(path);
+  c8.initialize();
+  REQUIRE( c8.getInstructionsPerFrame() == C8_INSTRUCTIONS_PER_FRAME );
+
+  // DT is set at instruction 1 and read at every odd one from 3 on
+  runFor(c8, 2 * C8_INSTRUCTIONS_PER_FRAME);
+  REQUIRE( c8.getClock() == 2 * C8_INSTRUCTIONS_PER_FRAME );
+  REQUIRE( c8.getRegisters()[0xB] == 4 );
+  REQUIRE_FALSE( c8.beepFlag );
+
+  runFor(c8, 4 * C8_INSTRUCTIONS_PER_FRAME);
+  REQUIRE( c8.getRegisters()[0xB] == 0 );
+  REQUIRE( c8.beepFlag );
+
+  // one instruction per frame ticks like the timers did before they were lazy
+  Processor::Chip8 fast(path);
+  fast.initialize();
+  fast.setInstructionsPerFrame(1);
+  runFor(fast, 4);
+  REQUIRE( fast.getRegisters()[0xB] == 3 );
+}
+
+TEST_CASE("Idle loops are skipped exactly as if they had run", "[processor]")
+{
+  const uint8_t program[] = {
+    0x6A, 0x3C,   // VA = 60
+    0xFA, 0x15,   // DT = VA
+    0xF0, 0x07,   // V0 = DT
+    0x30, 0x00,   // until V0 == 0
+    0x12, 0x04,
+    0x6B, 0x01,   // VB = 1
+    0x12, 0x0C    // and stop
+  };
+  const char *path = writeRom("/tmp/c8_idle.ch8", program, sizeof(program));
+
+  Processor::Chip8 stepped(path);
+  stepped.initialize();
+  for (int i = 0; i < 10000; ++i)
+  {
+    stepped.run(1);
+  }
+
+  Processor::Engine engines[] = {
+    Processor::ENGINE_DISPATCH, Processor::ENGINE_THREADED, Processor::ENGINE_BLOCK, Processor::ENGINE_JIT
+  };
+  for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e)
+  {
+    Processor::Chip8 c8(path);
+    c8.initialize();
+    c8.setEngine(engines[e]);
+    REQUIRE( c8.run(10000) == 10000 );
+    REQUIRE( c8.getClock() == 10000 );
+    REQUIRE( c8.getProgramCounter() == 0x20C );
+    REQUIRE( c8.getRegisters()[0xB] == 1 );
+    REQUIRE( c8 == stepped );
+  }
+
+  // waiting for the timer and then for nothing at all, barely any of it executed
+  Processor::Chip8 c8(path);
+  c8.initialize();
+  c8.run(10000);
+  REQUIRE( c8.getIdleCycles() > 9900 );
+}
+
+TEST_CASE("Fx0A blocks until a key is pressed and released", "[processor]")
+{
+  const uint8_t program[] = {
+    0x6A, 0x3C,   // VA = 60
+    0xFA, 0x15,   // DT = VA
+    0xF3, 0x0A,   // V3 = K
+    0xF4, 0x07,   // V4 = DT
+    0x12, 0x08    // and stop
+  };
+  const char *path = writeRom("/tmp/c8_key.ch8", program, sizeof(program));
+
+  Processor::Engine engines[] = {
+    Processor::ENGINE_DISPATCH, Processor::ENGINE_THREADED, Processor::ENGINE_BLOCK, Processor::ENGINE_JIT
+  };
+  for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e)
+  {
+    Processor::Chip8 c8(path);
+    c8.initialize();
+    c8.setEngine(engines[e]);
+
+    // blocked, but the clock and the timer keep going
+    REQUIRE( c8.run(100) == 100 );
+    REQUIRE( c8.getClock() == 100 );
+    REQUIRE( c8.getProgramCounter() == 0x204 );
+    REQUIRE( !c8.waitingForInput() );
+    c8.run(1000);
+    REQUIRE( c8.waitingForInput() );
+
+    c8.press(0x7, true);
+    c8.run(10);
+    REQUIRE( c8.getProgramCounter() == 0x204 );
+    c8.press(0x7, false);
+    c8.run(10);
+    REQUIRE( c8.getRegisters()[0x3] == 0x7 );
+    REQUIRE( c8.getRegisters()[0x4] == 0 );
+    REQUIRE( c8.getProgramCounter() == 0x208 );
+    REQUIRE( c8.getIdleCycles() > 1000 );
+  }
+
+  // a key tapped between two runs isn't lost, and lanes wait the same way
+  Processor::Chip8 c8(path);
+  c8.initialize();
+  Processor::Lanes<8> *lanes = new Processor::Lanes<8>(path);
+  c8.run(1000);
+  lanes->run(1000);
+  c8.press(0xC, true);
+  c8.press(0xC, false);
+  lanes->press(0, 0xC, true);
+  lanes->press(0, 0xC, false);
+  c8.run(5);
+  lanes->run(5);
+  REQUIRE( c8.getRegisters()[0x3] == 0xC );
+  REQUIRE( lanes->matches(0, c8) );
+  REQUIRE( lanes->getProgramCounter(1) == 0x204 );
+  delete lanes;
+}
+
+TEST_CASE("Lockstep lanes match a processor per lane", "[processor]")
+{
+  // different seeds and paddle keys make the lanes diverge and reconverge
+  const uint8_t keys[] = { 0x1, 0x4, 0xC, 0xD };
+  Processor::Lanes<8> *lanes = new Processor::Lanes<8>("resources/pong");
+  for (int lane = 0; lane < 8; ++lane)
+  {
+    lanes->seed(lane, lane + 1);
+    lanes->key[lane][keys[lane % 4]] = lane < 4;
+  }
+
+  REQUIRE( lanes->run(20000) == 8 * 20000 );
+  REQUIRE( lanes->run(30000) == 8 * 30000 );
+
+  bool same = true;
+  for (int lane = 0; lane < 8; ++lane)
+  {
+    Processor::Chip8 c8("resources/pong");
+    c8.initialize();
+    c8.seed(lane + 1);
+    c8.key[keys[lane % 4]] = lane < 4;
+    runFor(c8, 50000);
+    same = same && lanes->matches(lane, c8);
+  }
+  REQUIRE( same );
+  delete lanes;
+}
+
+TEST_CASE("Lanes wrap I, the stack pointer and key numbers the way a processor does", "[processor]")
+{
+  const uint8_t program[] = {
+    0x60, 0xFF,   // V0 = 255
+    0xAF, 0xFE,   // I = 0xFFE
+    0xF0, 0x33,   // BCD across the end of memory
+    0xF2, 0x65,   // and back, I = 0x1001
+    0xF0, 0x33,
+    0x63, 0x13,   // V3 = 0x13
+    0xE3, 0x9E,   // skip if key 3 is down
+    0xFF, 0xFF,
+    0x22, 0x10    // call itself, deeper than the stack
+  };
+  const char *path = writeRom("/tmp/c8_lanes_wrap.ch8", program, sizeof(program));
+
+  Processor::Lanes<8> *lanes = new Processor::Lanes<8>(path);
+  for (int lane = 0; lane < 8; ++lane)
+  {
+    lanes->key[lane][0x3] = 1;
+  }
+  REQUIRE( lanes->run(100) == 8 * 100 );
+
+  Processor::Chip8 c8(path);
+  c8.initialize();
+  c8.key[0x3] = 1;
+  runFor(c8, 100);
+  REQUIRE( lanes->matches(0, c8) );
+  REQUIRE( lanes->matches(7, c8) );
+  delete lanes;
+}
@@ -1,2 +1,4 @@
 #define CATCH_CONFIG_MAIN
+// glibc 2.34+ no longer has a constant SIGSTKSZ, which catch uses for its signal stack
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
 #include "test/catch.hpp"
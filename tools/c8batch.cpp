@@ -0,0 +1,497 @@
+/*
+  c8batch - runs many ROM instances across every core
+
+  Reads a manifest with one run per line:
+
+    <ROM file> <cycles> [<input script> | -] [<seed>]
+
+  and prints one JSON result per run, in manifest order: the instructions
+  executed and how many of those were idle loops skipped rather than run,
+  whether the ROM halted on an unimplemented opcode, a hash of the final
+  framebuffer, the registers and the wall time. Runs are spread over a
+  work-stealing pool, each worker owns a queue and steals from the others
+  once its own is empty.
+
+  An input script presses and releases keys at given instruction counts,
+  one event per line:
+
+    <cycle> <key 0-F> down|up
+
+  Blank lines and lines starting with '#' are ignored in both files.
+
+  With --lanes, runs of the same ROM and cycle budget are packed 8, 16 or
+  32 at a time into lockstep SIMD lanes (see processor/lanes.hpp) instead
+  of getting a processor each; their wall time is that of the whole pack.
+  Lanes run idle loops rather than skipping them, so their results have
+  no "idle" count.
+
+  Usage: c8batch [--threads=<n>] [--engine=dispatch|threaded|block|jit] [--lanes=8|16|32] <manifest>
+*/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "processor/chip8.hpp"
+#include "processor/lanes.hpp"
+
+struct InputEvent
+{
+  uint64_t cycle;
+  uint8_t  key;
+  bool     down;
+};
+
+struct Job
+{
+  std::string rom;
+  uint64_t    cycles;
+  uint32_t    seed;
+  std::vector<InputEvent> input;
+};
+
+struct Result
+{
+  std::string error;
+  uint64_t executed;
+  uint64_t idle;
+  bool     countsIdle;  // false for lanes, which run idle loops instead of skipping them
+  bool     halted;
+  uint64_t framebufferHash;
+  uint8_t  registers[16];
+  uint16_t I;
+  uint16_t pc;
+  double   wallSeconds;
+};
+
+/*
+  Per-worker queues of work item indices. Owners take from the back of their own
+  queue, thieves from the front of someone else's.
+*/
+class WorkStealingPool
+{
+  private:
+    struct Queue
+    {
+      std::mutex lock;
+      std::deque<size_t> jobs;
+    };
+    std::vector<Queue> queues;
+
+  public:
+    WorkStealingPool(size_t workers, size_t items) : queues(workers)
+    {
+      for (size_t item = 0; item < items; ++item)
+      {
+        this->queues[item % workers].jobs.push_back(item);
+      }
+    }
+
+    bool
+    next(size_t worker, size_t &job)
+    {
+      for (size_t i = 0; i < this->queues.size(); ++i)
+      {
+        Queue &queue = this->queues[(worker + i) % this->queues.size()];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if ( queue.jobs.empty() )
+        {
+          continue;
+        }
+        if ( i == 0 )
+        {
+          job = queue.jobs.back();
+          queue.jobs.pop_back();
+        }
+        else
+        {
+          job = queue.jobs.front();
+          queue.jobs.pop_front();
+        }
+        return true;
+      }
+      return false;
+    }
+};
+
+// skips blank lines and comments
+static bool
+nextLine(std::istream &in, std::istringstream &line)
+{
+  std::string text;
+  while ( std::getline(in, text) )
+  {
+    size_t start = text.find_first_not_of(" \t\r");
+    if ( start == std::string::npos || text[start] == '#' )
+    {
+      continue;
+    }
+    line.clear();
+    line.str(text);
+    return true;
+  }
+  return false;
+}
+
+static bool
+readInput(const std::string &path, std::vector<InputEvent> &events)
+{
+  std::ifstream file(path.c_str());
+  if ( !file )
+  {
+    return false;
+  }
+
+  std::istringstream line;
+  while ( nextLine(file, line) )
+  {
+    InputEvent event;
+    unsigned int key;
+    std::string state;
+    if ( !(line >> event.cycle >> std::hex >> key >> state) || key > 0xF || (state != "down" && state != "up") )
+    {
+      return false;
+    }
+    event.key  = key;
+    event.down = state == "down";
+    events.push_back(event);
+  }
+  return true;
+}
+
+// FNV-1a over the framebuffer rows, most significant byte first on any host
+static uint64_t
+hash(const uint64_t *rows)
+{
+  uint64_t value = 14695981039346656037ULL;
+  for (int row = 0; row < C8_GFX_WIDTH; ++row)
+  {
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+      value = (value ^ ((rows[row] >> shift) & 0xFF)) * 1099511628211ULL;
+    }
+  }
+  return value;
+}
+
+static Result
+run(const Job &job, Processor::Engine engine)
+{
+  Result result;
+  result.executed = 0;
+  result.idle = 0;
+  result.countsIdle = true;
+  result.halted = false;
+
+  if ( !std::ifstream(job.rom.c_str()) )
+  {
+    result.error = "can't read " + job.rom;
+    return result;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  Processor::Chip8 c8(job.rom.c_str());
+  c8.initialize();
+  c8.seed(job.seed);
+  c8.setEngine(engine);
+
+  size_t event = 0;
+  while ( result.executed < job.cycles && !c8.halted )
+  {
+    while ( event < job.input.size() && job.input[event].cycle <= result.executed )
+    {
+      c8.press(job.input[event].key, job.input[event].down);
+      ++event;
+    }
+
+    uint64_t until = job.cycles;
+    if ( event < job.input.size() && job.input[event].cycle < until )
+    {
+      until = job.input[event].cycle;
+    }
+    uint64_t slice = until - result.executed;
+    result.executed += c8.run(slice > 0xFFFFFFFFULL ? 0xFFFFFFFFU : (uint32_t)slice);
+    c8.drawFlag = false;
+    c8.beepFlag = false;
+  }
+
+  result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.idle = c8.getIdleCycles();
+  result.halted = c8.halted;
+  result.framebufferHash = hash(c8.graphicsBuffer);
+  memcpy(result.registers, c8.getRegisters(), sizeof(result.registers));
+  result.I  = c8.getIndexRegister();
+  result.pc = c8.getProgramCounter();
+  return result;
+}
+
+/*
+  Runs a pack of jobs sharing a ROM and cycle budget in lanes, stopping
+  wherever one of their input scripts has an event
+*/
+template<int N>
+static void
+runLanes(const std::vector<Job> &jobs, const std::vector<size_t> &pack, std::vector<Result> &results)
+{
+  const Job &first = jobs[pack[0]];
+  if ( !std::ifstream(first.rom.c_str()) )
+  {
+    for (size_t i = 0; i < pack.size(); ++i)
+    {
+      results[pack[i]].error = "can't read " + first.rom;
+    }
+    return;
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  Processor::Lanes<N> *lanes = new Processor::Lanes<N>(first.rom.c_str());
+  size_t event[N] = { 0 };
+  for (int lane = 0; lane < N; ++lane)
+  {
+    // spare lanes run a copy of the first job and are thrown away
+    lanes->seed(lane, jobs[pack[(size_t)lane < pack.size() ? lane : 0]].seed);
+  }
+
+  uint64_t done = 0;
+  while ( done < first.cycles )
+  {
+    uint64_t until = first.cycles;
+    for (int lane = 0; lane < N; ++lane)
+    {
+      const Job &job = jobs[pack[(size_t)lane < pack.size() ? lane : 0]];
+      while ( event[lane] < job.input.size() && job.input[event[lane]].cycle <= done )
+      {
+        lanes->press(lane, job.input[event[lane]].key, job.input[event[lane]].down);
+        ++event[lane];
+      }
+      if ( event[lane] < job.input.size() && job.input[event[lane]].cycle < until )
+      {
+        until = job.input[event[lane]].cycle;
+      }
+    }
+
+    uint64_t slice = until - done;
+    if ( slice > 0xFFFFFFFFULL )
+    {
+      slice = 0xFFFFFFFFULL;
+    }
+    lanes->run((uint32_t)slice);
+    done += slice;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  for (size_t lane = 0; lane < pack.size(); ++lane)
+  {
+    Result &result = results[pack[lane]];
+    result.executed = lanes->getInstructions(lane);
+    result.idle = 0;
+    result.countsIdle = false;
+    result.halted = lanes->halted[lane];
+    result.framebufferHash = hash(lanes->graphicsBuffer[lane]);
+    for (int i = 0; i < 16; ++i)
+    {
+      result.registers[i] = lanes->getRegister(lane, i);
+    }
+    result.I  = lanes->getIndexRegister(lane);
+    result.pc = lanes->getProgramCounter(lane);
+    result.wallSeconds = seconds;
+  }
+  delete lanes;
+}
+
+static void
+print(const Job &job, const Result &result)
+{
+  std::string rom;
+  for (size_t i = 0; i < job.rom.size(); ++i)
+  {
+    if ( job.rom[i] == '"' || job.rom[i] == '\\' )
+    {
+      rom += '\\';
+    }
+    rom += job.rom[i];
+  }
+
+  char line[512];
+  if ( !result.error.empty() )
+  {
+    snprintf(line, sizeof(line), "{\"rom\":\"%s\",\"error\":\"%s\"}", rom.c_str(), result.error.c_str());
+    std::cout << line << '\n';
+    return;
+  }
+
+  int length = snprintf(line, sizeof(line), "{\"rom\":\"%s\",\"instructions\":%llu,",
+    rom.c_str(), (unsigned long long)result.executed);
+  if ( result.countsIdle )
+  {
+    length += snprintf(line + length, sizeof(line) - length, "\"idle\":%llu,", (unsigned long long)result.idle);
+  }
+  length += snprintf(line + length, sizeof(line) - length, "\"halted\":%s,\"framebuffer\":\"%016llx\",\"pc\":%u,\"i\":%u,\"v\":[",
+    result.halted ? "true" : "false", (unsigned long long)result.framebufferHash, result.pc, result.I);
+  for (int i = 0; i < 16; ++i)
+  {
+    length += snprintf(line + length, sizeof(line) - length, i ? ",%u" : "%u", result.registers[i]);
+  }
+  snprintf(line + length, sizeof(line) - length, "],\"wall_seconds\":%.6f}", result.wallSeconds);
+  std::cout << line << '\n';
+}
+
+int
+main( const int argc, const char **argv )
+{
+  const char *manifestFile = NULL;
+  size_t threads = std::thread::hardware_concurrency();
+  Processor::Engine engine = Processor::ENGINE_DISPATCH;
+  int lanes = 0;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg.compare(0, 10, "--threads=") == 0)
+    {
+      threads = strtoul(argv[i] + 10, NULL, 10);
+    }
+    else if (arg == "--engine=dispatch")
+    {
+      engine = Processor::ENGINE_DISPATCH;
+    }
+    else if (arg == "--engine=threaded")
+    {
+      engine = Processor::ENGINE_THREADED;
+    }
+    else if (arg == "--engine=block")
+    {
+      engine = Processor::ENGINE_BLOCK;
+    }
+    else if (arg == "--engine=jit")
+    {
+      engine = Processor::ENGINE_JIT;
+    }
+    else if (arg == "--lanes=8" || arg == "--lanes=16" || arg == "--lanes=32")
+    {
+      lanes = atoi(argv[i] + 8);
+    }
+    else
+    {
+      manifestFile = argv[i];
+    }
+  }
+
+  if (manifestFile == NULL) {
+    std::cerr << "Usage: c8batch [--threads=<n>] [--engine=dispatch|threaded|block|jit] [--lanes=8|16|32] <manifest>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream manifest(manifestFile);
+  if ( !manifest )
+  {
+    std::cerr << "c8batch: can't read " << manifestFile << std::endl;
+    return 1;
+  }
+
+  std::vector<Job> jobs;
+  std::istringstream line;
+  while ( nextLine(manifest, line) )
+  {
+    Job job;
+    std::string input;
+    job.seed = 1;
+    if ( !(line >> job.rom >> job.cycles) )
+    {
+      std::cerr << "c8batch: bad manifest line: " << line.str() << std::endl;
+      return 1;
+    }
+    if ( (line >> input) && input != "-" && !readInput(input, job.input) )
+    {
+      std::cerr << "c8batch: bad input script " << input << std::endl;
+      return 1;
+    }
+    uint32_t seed;
+    if ( line >> seed )
+    {
+      job.seed = seed;
+    }
+    jobs.push_back(job);
+  }
+
+  // the unit of work: one job, or with lanes up to one job per lane
+  std::vector< std::vector<size_t> > packs;
+  std::map<std::pair<std::string, uint64_t>, size_t> open;
+  for (size_t job = 0; job < jobs.size(); ++job)
+  {
+    if ( lanes == 0 )
+    {
+      packs.push_back(std::vector<size_t>(1, job));
+      continue;
+    }
+
+    std::pair<std::string, uint64_t> key(jobs[job].rom, jobs[job].cycles);
+    std::map<std::pair<std::string, uint64_t>, size_t>::iterator pack = open.find(key);
+    if ( pack == open.end() || packs[pack->second].size() == (size_t)lanes )
+    {
+      open[key] = packs.size();
+      packs.push_back(std::vector<size_t>());
+    }
+    packs[open[key]].push_back(job);
+  }
+
+  if ( threads == 0 )
+  {
+    threads = 1;
+  }
+  if ( threads > packs.size() && !packs.empty() )
+  {
+    threads = packs.size();
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  std::vector<Result> results(jobs.size());
+  WorkStealingPool pool(threads, packs.size());
+  std::vector<std::thread> workers;
+  for (size_t worker = 0; worker < threads; ++worker)
+  {
+    workers.push_back(std::thread([&, worker]() {
+      size_t item;
+      while ( pool.next(worker, item) )
+      {
+        const std::vector<size_t> &pack = packs[item];
+        switch (lanes)
+        {
+          case 8:  runLanes<8>(jobs, pack, results); break;
+          case 16: runLanes<16>(jobs, pack, results); break;
+          case 32: runLanes<32>(jobs, pack, results); break;
+          default: results[pack[0]] = run(jobs[pack[0]], engine);
+        }
+      }
+    }));
+  }
+  for (size_t i = 0; i < workers.size(); ++i)
+  {
+    workers[i].join();
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint64_t instructions = 0;
+  int failed = 0;
+  for (size_t i = 0; i < jobs.size(); ++i)
+  {
+    print(jobs[i], results[i]);
+    instructions += results[i].executed;
+    failed += results[i].error.empty() ? 0 : 1;
+  }
+
+  std::cerr << jobs.size() << " runs on " << threads << " threads in " << seconds << "s, "
+            << (seconds > 0 ? instructions / seconds / 1e6 : 0) << " MIPS" << std::endl;
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,371 @@
+/*
+  c8rc - ahead of time CHIP-8 to C++ recompiler
+
+  Recovers the control flow graph of a ROM starting at 0x200 and writes a
+  C++ translation unit with one function per reachable basic block. Linked
+  into c8 it registers itself, and `--engine=precompiled` runs those blocks
+  whenever the loaded ROM matches, interpreting everything else.
+
+  Usage: c8rc <ROM file> > precompiled.cpp
+*/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdio>
+#include <cstdarg>
+#include "processor/chip8.hpp"
+
+struct Block
+{
+  uint16_t start;
+  uint16_t end;
+  std::vector<uint16_t> opCodes;
+};
+
+static std::string
+format(const char *fmt, ...)
+{
+  char line[256];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  return line;
+}
+
+/*
+  Operations that have to go through the interpreter handler rather than be
+  written out inline
+*/
+static bool
+interpreted(uint8_t operation)
+{
+  switch (operation)
+  {
+    case Processor::OP_CLS:
+    case Processor::OP_RND_VX_BYTE:
+    case Processor::OP_DRW_VX_VY_NIBBLE:
+    case Processor::OP_SKP_VX:
+    case Processor::OP_SKNP_VX:
+    case Processor::OP_LD_VX_DT:
+    case Processor::OP_LD_DT_VX:
+    case Processor::OP_LD_ST_VX:
+    case Processor::OP_LD_B_VX:
+    case Processor::OP_LD_VX_K:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*
+  Follows straight-line code from `start`, adding the addresses control can
+  continue at to `successors`. Blocks end at anything that changes the
+  program counter, draws (the host has to get a chance to redraw), writes
+  memory (which may be the code that follows) or waits for a key.
+*/
+static Block
+recover(const uint8_t *memory, uint16_t romEnd, uint16_t start, std::vector<uint16_t> &successors)
+{
+  Block block;
+  block.start = start;
+
+  uint16_t address = start;
+  while ( address + 1 < romEnd )
+  {
+    uint16_t opCode = memory[address] << 8 | memory[address + 1];
+    Processor::Chip8::Instruction op = Processor::Chip8::decode(opCode);
+
+    // unknown opcodes are left to the interpreter
+    if ( op.operation == Processor::OP_UNIMPLEMENTED )
+    {
+      if ( !block.opCodes.empty() )
+      {
+        successors.push_back(address);
+      }
+      break;
+    }
+
+    block.opCodes.push_back(opCode);
+    address += 2;
+
+    bool ends = true;
+    switch (op.operation)
+    {
+      case Processor::OP_JP_ADDR:
+        successors.push_back(op.nnn);
+        break;
+      case Processor::OP_CALL_ADDR:
+        successors.push_back(op.nnn);
+        successors.push_back(address);    // where the subroutine returns to
+        break;
+      case Processor::OP_RET:
+        break;
+      case Processor::OP_SE_VX_BYTE:
+      case Processor::OP_SNE_VX_BYTE:
+      case Processor::OP_SKP_VX:
+      case Processor::OP_SKNP_VX:
+        successors.push_back(address);
+        successors.push_back(address + 2);
+        break;
+      case Processor::OP_CLS:
+      case Processor::OP_DRW_VX_VY_NIBBLE:
+      case Processor::OP_LD_B_VX:
+      case Processor::OP_LD_VX_K:
+        successors.push_back(address);
+        break;
+      default:
+        ends = false;
+    }
+
+    if ( ends )
+    {
+      break;
+    }
+  }
+
+  block.end = address;
+  return block;
+}
+
+/*
+  Writes a block as a function. Inline code mirrors the interpreter handlers
+  statement for statement; timer ticks for inline instructions are batched
+  and settled before anything that may look at the timers.
+*/
+static void
+emitBlock(std::ostream &out, const Block &block)
+{
+  out << format("// 0x%03X - 0x%03X\n", block.start, block.end);
+  out << format("static void\nblock_%03X(Processor::Chip8 &c8)\n{\n", block.start);
+  out << "  uint8_t  *V      = Processor::Precompiled::V(c8);\n";
+  out << "  uint16_t &I      = Processor::Precompiled::I(c8);\n";
+  out << "  uint16_t &pc     = Processor::Precompiled::pc(c8);\n";
+  out << "  uint16_t *stack  = Processor::Precompiled::stack(c8);\n";
+  out << "  uint16_t &sp     = Processor::Precompiled::sp(c8);\n";
+  out << "  uint8_t  *memory = Processor::Precompiled::memory(c8);\n";
+  out << "  (void)V; (void)I; (void)stack; (void)sp; (void)memory;\n\n";
+
+  uint32_t pending = 0;
+  for (size_t i = 0; i < block.opCodes.size(); ++i)
+  {
+    uint16_t address = block.start + i * 2;
+    uint16_t opCode = block.opCodes[i];
+    Processor::Chip8::Instruction op = Processor::Chip8::decode(opCode);
+
+    out << format("  // 0x%03X: %04x\n", address, opCode);
+
+    if ( interpreted(op.operation) )
+    {
+      if ( pending )
+      {
+        out << format("  Processor::Precompiled::tick(c8, %u);\n", pending);
+        pending = 0;
+      }
+      out << format("  pc = 0x%03X;\n", address);
+      out << format("  Processor::Precompiled::execute(c8, 0x%04X);\n", opCode);
+      continue;
+    }
+
+    ++pending;
+    switch (op.operation)
+    {
+      case Processor::OP_RET:
+        out << "  --sp;\n  pc = stack[sp & 0xF];\n  pc += 2;\n";
+        break;
+      case Processor::OP_JP_ADDR:
+        out << format("  pc = 0x%03X;\n", op.nnn);
+        break;
+      case Processor::OP_CALL_ADDR:
+        out << format("  stack[sp & 0xF] = 0x%03X;\n  ++sp;\n  pc = 0x%03X;\n", address, op.nnn);
+        break;
+      case Processor::OP_SE_VX_BYTE:
+        out << format("  pc = ( V[0x%X] == 0x%02X ) ? 0x%03X : 0x%03X;\n", op.x, op.kk, address + 4, address + 2);
+        break;
+      case Processor::OP_SNE_VX_BYTE:
+        out << format("  pc = ( V[0x%X] != 0x%02X ) ? 0x%03X : 0x%03X;\n", op.x, op.kk, address + 4, address + 2);
+        break;
+      case Processor::OP_LD_VX_BYTE:
+        out << format("  V[0x%X] = 0x%02X;\n", op.x, op.kk);
+        break;
+      case Processor::OP_ADD_VX_BYTE:
+        out << format("  V[0x%X] += 0x%02X;\n", op.x, op.kk);
+        break;
+      case Processor::OP_LD_VX_VY:
+        out << format("  V[0x%X] = V[0x%X];\n", op.x, op.y);
+        break;
+      case Processor::OP_OR_VX_VY:
+        out << format("  V[0x%X] |= V[0x%X];\n", op.x, op.y);
+        break;
+      case Processor::OP_AND_VX_VY:
+        out << format("  V[0x%X] &= V[0x%X];\n", op.x, op.y);
+        break;
+      case Processor::OP_XOR_VX_VY:
+        out << format("  V[0x%X] ^= V[0x%X];\n", op.x, op.y);
+        break;
+      case Processor::OP_ADD_VX_VY:
+        out << format("  V[0x%X] += V[0x%X];\n", op.x, op.y);
+        out << "  V[0xF] = 0;\n";
+        out << format("  if ( V[0x%X] > (0xFF - V[0x%X]) ) V[0xF] = 1;\n", op.y, op.x);
+        break;
+      case Processor::OP_SUB_VX_VY:
+        out << "  V[0xF] = 1;\n";
+        out << format("  if ( V[0x%X] > V[0x%X] ) V[0xF] = 0;\n", op.y, op.x);
+        out << format("  V[0x%X] -= V[0x%X];\n", op.x, op.y);
+        break;
+      case Processor::OP_SHR_VX:
+        out << format("  V[0xF] = V[0x%X] & 0x1;\n", op.x);
+        out << format("  V[0x%X] >>= 1;\n", op.x);
+        break;
+      case Processor::OP_SUBN_VX_VY:
+        out << "  V[0xF] = 1;\n";
+        out << format("  if ( V[0x%X] > V[0x%X] ) V[0xF] = 0;\n", op.x, op.y);
+        out << format("  V[0x%X] = V[0x%X] - V[0x%X];\n", op.x, op.y, op.x);
+        break;
+      case Processor::OP_SHL_VX:
+        out << format("  V[0xF] = V[0x%X] >> 7;\n", op.x);
+        out << format("  V[0x%X] <<= 1;\n", op.x);
+        break;
+      case Processor::OP_LD_I_ADDR:
+        out << format("  I = 0x%03X;\n", op.nnn);
+        break;
+      case Processor::OP_ADD_I_VX:
+        out << format("  { uint8_t value = V[0x%X];\n", op.x);
+        out << "    V[0xF] = 0;\n";
+        out << "    if ( (I + value) > 0xFFF ) V[0xF] = 1;\n";
+        out << "    I += value; }\n";
+        break;
+      case Processor::OP_LD_F_VX:
+        out << format("  I = V[0x%X] * 0x5;\n", op.x);
+        break;
+      case Processor::OP_LD_VX_I:
+        out << format("  for (int i = 0; i <= 0x%X; ++i) V[i] = memory[(I + i) & 0xFFF];\n", op.x);
+        out << format("  I += 0x%X + 1;\n", op.x);
+        break;
+    }
+  }
+
+  // fell off the end of the block without a control transfer
+  Processor::Chip8::Instruction last = Processor::Chip8::decode(block.opCodes.back());
+  bool transfers = last.operation == Processor::OP_RET
+    || last.operation == Processor::OP_JP_ADDR
+    || last.operation == Processor::OP_CALL_ADDR
+    || last.operation == Processor::OP_SE_VX_BYTE
+    || last.operation == Processor::OP_SNE_VX_BYTE
+    || interpreted(last.operation);
+  if ( !transfers )
+  {
+    out << format("  pc = 0x%03X;\n", block.end);
+  }
+
+  if ( pending )
+  {
+    out << format("  Processor::Precompiled::tick(c8, %u);\n", pending);
+  }
+  out << "}\n\n";
+}
+
+static std::string
+identifier(const std::string &path)
+{
+  std::string name = path.substr(path.find_last_of('/') + 1);
+  for (size_t i = 0; i < name.size(); ++i)
+  {
+    if ( !isalnum((unsigned char)name[i]) )
+    {
+      name[i] = '_';
+    }
+  }
+  return name;
+}
+
+int
+main( const int argc, const char **argv )
+{
+  if (argc < 2) {
+    std::cerr << "Usage: c8rc <ROM file> > precompiled.cpp" << std::endl;
+    return 1;
+  }
+
+  std::ifstream file(argv[1], std::ios::binary);
+  if ( !file )
+  {
+    std::cerr << "c8rc: can't read " << argv[1] << std::endl;
+    return 1;
+  }
+
+  uint8_t memory[4096] = { 0 };
+  uint16_t size = 0;
+  char byte;
+  while ( file.get(byte) && C8_MEMORY_OFFSET + size < 4096 )
+  {
+    memory[C8_MEMORY_OFFSET + size] = (uint8_t)byte;
+    ++size;
+  }
+  uint16_t romEnd = C8_MEMORY_OFFSET + size;
+
+  // breadth first over every address control can reach from the entry point
+  std::map<uint16_t, Block> blocks;
+  std::vector<uint16_t> worklist(1, C8_MEMORY_OFFSET_HEX);
+  std::set<uint16_t> seen;
+  while ( !worklist.empty() )
+  {
+    uint16_t start = worklist.back();
+    worklist.pop_back();
+    if ( seen.count(start) || start < C8_MEMORY_OFFSET || start + 1 >= romEnd )
+    {
+      continue;
+    }
+    seen.insert(start);
+
+    std::vector<uint16_t> successors;
+    Block block = recover(memory, romEnd, start, successors);
+    if ( !block.opCodes.empty() )
+    {
+      blocks[start] = block;
+    }
+    worklist.insert(worklist.end(), successors.begin(), successors.end());
+  }
+
+  std::string name = identifier(argv[1]);
+  std::ostream &out = std::cout;
+
+  out << "// Generated by c8rc from " << argv[1] << ", do not edit\n";
+  out << "#include \"processor/precompiled.hpp\"\n\n";
+  out << "namespace\n{\n\n";
+
+  out << "const uint8_t image[] = {";
+  for (uint16_t i = 0; i < size; ++i)
+  {
+    out << (i % 16 ? " " : "\n  ") << format("0x%02x,", memory[C8_MEMORY_OFFSET + i]);
+  }
+  out << "\n};\n\n";
+
+  for (std::map<uint16_t, Block>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+  {
+    emitBlock(out, it->second);
+  }
+
+  out << "const Processor::PrecompiledBlock blocks[] = {\n";
+  for (std::map<uint16_t, Block>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+  {
+    const Block &block = it->second;
+    out << format("  { 0x%03X, 0x%03X, %u, block_%03X },\n",
+      block.start, block.end, (unsigned)block.opCodes.size(), block.start);
+  }
+  out << "};\n\n";
+
+  out << "const Processor::PrecompiledRom rom = {\n";
+  out << "  \"" << name << "\", image, sizeof(image), blocks, sizeof(blocks) / sizeof(blocks[0])\n";
+  out << "};\n\n";
+
+  out << "struct Registration\n{\n  Registration() { Processor::Precompiled::add(&rom); }\n} registration;\n\n";
+  out << "}\n";
+
+  std::cerr << "c8rc: " << blocks.size() << " blocks from " << size << " bytes" << std::endl;
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*
+  c8trace - decodes binary execution traces recorded with `c8 --trace-file`
+
+  Prints one entry per instruction in the same format the interpreter used
+  to log to stdout, `handler: <hexdump of the opcode>`, and like it leaves
+  out se_vx_byte, sne_vx_byte and fx_ld_st_vx, which never logged. Fx0A
+  came later and prints as fx_ld_vx_k. With -v every instruction gets an
+  entry, prefixed with the cycle, address, index register and the register
+  the instruction changed.
+
+  Usage: c8trace [-v] <trace file>
+*/
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "processor/chip8.hpp"
+
+int
+main( const int argc, const char **argv )
+{
+  bool verbose = false;
+  const char *path = NULL;
+  for (int i = 1; i < argc; ++i)
+  {
+    if ( strcmp(argv[i], "-v") == 0 )
+    {
+      verbose = true;
+    }
+    else
+    {
+      path = argv[i];
+    }
+  }
+
+  if (path == NULL) {
+    std::cerr << "Usage: c8trace [-v] <trace file>" << std::endl;
+    return 1;
+  }
+
+  FILE *file = fopen(path, "rb");
+  if ( file == NULL )
+  {
+    std::cerr << "c8trace: can't read " << path << std::endl;
+    return 1;
+  }
+
+  Debug::TraceHeader header;
+  if ( fread(&header, sizeof(header), 1, file) != 1
+    || memcmp(header.magic, C8_TRACE_MAGIC, 4) != 0
+    || header.version != C8_TRACE_VERSION
+    || header.recordSize != sizeof(Debug::TraceRecord) )
+  {
+    std::cerr << "c8trace: " << path << " is not a trace this version can read" << std::endl;
+    fclose(file);
+    return 1;
+  }
+
+  Debug::TraceRecord record;
+  while ( fread(&record, sizeof(record), 1, file) == 1 )
+  {
+    uint8_t operation = Processor::Chip8::decode(record.opCode).operation;
+    if ( !verbose && !Debug::handlerLogged(operation) )
+    {
+      continue;
+    }
+
+    if ( verbose )
+    {
+      char prefix[64];
+      if ( record.reg == C8_TRACE_NO_REGISTER )
+      {
+        snprintf(prefix, sizeof(prefix), "%10u  %03X  I=%03X         ", record.cycle, record.pc, record.I);
+      }
+      else
+      {
+        snprintf(prefix, sizeof(prefix), "%10u  %03X  I=%03X  V%X=%02X  ",
+          record.cycle, record.pc, record.I, record.reg, record.value);
+      }
+      std::cout << prefix;
+    }
+
+    std::cout << Debug::handlerName(operation) << ": " << hexdump(record.opCode) << std::endl;
+  }
+
+  fclose(file);
+  return 0;
+}